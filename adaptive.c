@@ -0,0 +1,133 @@
+/* Name : Shobharaj H L
+   Date : 12/11/2025
+   Description : LSB_IMAGE_STEGANOGRAPHY */
+#define _FILE_OFFSET_BITS 64
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "adaptive.h"
+#include "png.h"
+#include "common.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+ // Function: adaptive_header_len
+ // Purpose : Bits the header fields take before the adaptive payload starts
+uint64_t adaptive_header_len(const char *extn)
+{
+    return (strlen(MAGIC_STRING_ADAPTIVE) + 1 + 4 + strlen(extn) + 4) * 8;
+}
+
+ // Function: adaptive_geometry
+ // Purpose : Row layout of the pixel data and the first row free for payload
+int adaptive_geometry(const char *bmp_header, uint64_t header_len, AdaptiveGeometry *geo)
+{
+    int32_t width, height;
+    uint16_t bpp;
+
+    memcpy(&width, bmp_header + 18, sizeof(width));
+    memcpy(&height, bmp_header + 22, sizeof(height));
+    memcpy(&bpp, bmp_header + 28, sizeof(bpp));
+    if (height < 0)
+        height = -height;
+    if (bpp != 24 || width <= 2 || height <= 2)
+        return -1;
+
+    geo->row_bytes = (size_t)width * 3;
+    geo->stride = bmp_row_stride(bmp_header);
+    geo->height = height;
+    geo->first_row = (header_len + geo->stride - 1) / geo->stride;
+    return 0;
+}
+
+static inline unsigned char abs_diff_7bit(unsigned char a, unsigned char b)
+{
+    a >>= 1;
+    b >>= 1;
+    return a > b ? a - b : b - a;
+}
+
+ // Function: adaptive_select_row
+ // Purpose : One pass over a row: |left - right| + |up - down| >= threshold
+size_t adaptive_select_row(const unsigned char *prev, const unsigned char *cur, const unsigned char *next,
+                           size_t row_bytes, unsigned char threshold, unsigned char *sel)
+{
+    size_t count = 0;
+    size_t x = 3;
+
+    memset(sel, 0, row_bytes);
+    if (row_bytes < 7)
+        return 0;
+
+#ifdef __SSE2__
+    const __m128i mask = _mm_set1_epi8(0x7F);
+    const __m128i thr = _mm_set1_epi8((char)threshold);
+
+    for (; x + 16 + 3 <= row_bytes; x += 16)
+    {
+        // Drop the LSB: 16 bit shift, then clear the bit shifted in from the next byte
+        __m128i l = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128((const __m128i *)(cur + x - 3)), 1), mask);
+        __m128i r = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128((const __m128i *)(cur + x + 3)), 1), mask);
+        __m128i u = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128((const __m128i *)(prev + x)), 1), mask);
+        __m128i d = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128((const __m128i *)(next + x)), 1), mask);
+
+        __m128i h = _mm_or_si128(_mm_subs_epu8(l, r), _mm_subs_epu8(r, l));
+        __m128i v = _mm_or_si128(_mm_subs_epu8(u, d), _mm_subs_epu8(d, u));
+        __m128i sum = _mm_adds_epu8(h, v);
+        __m128i hit = _mm_cmpeq_epi8(_mm_max_epu8(sum, thr), sum);
+
+        _mm_storeu_si128((__m128i *)(sel + x), hit);
+        count += __builtin_popcount(_mm_movemask_epi8(hit));
+    }
+#endif
+
+    for (; x + 3 < row_bytes; x++)
+    {
+        unsigned sum = abs_diff_7bit(cur[x - 3], cur[x + 3]) + abs_diff_7bit(prev[x], next[x]);
+        sel[x] = sum >= threshold ? 0xFF : 0;
+        count += sel[x] & 1;
+    }
+    return count;
+}
+
+ // Function: adaptive_capacity
+ // Purpose : Count the bytes the encoder will select, without moving the stream
+int adaptive_capacity(FILE *fptr, const AdaptiveGeometry *geo, unsigned char threshold, uint64_t limit,
+                      uint64_t *count)
+{
+    off_t start = ftello(fptr);
+    int ret = -1;
+
+    // Pipes cannot be rewound after the count
+    if (start < 0 || fseeko(fptr, start + (off_t)(geo->first_row * geo->stride), SEEK_SET) != 0)
+        return -1;
+
+    unsigned char *rows = malloc(geo->stride * 3 + geo->row_bytes);
+    if (rows == NULL)
+        goto out;
+    unsigned char *prev = rows, *cur = rows + geo->stride, *next = rows + 2 * geo->stride;
+    unsigned char *sel = rows + 3 * geo->stride;
+
+    // Same window as the encoder; only the upper 7 bits decide, so the cover gives the same answer
+    *count = 0;
+    if (fread(prev, 1, geo->stride, fptr) != geo->stride || fread(cur, 1, geo->stride, fptr) != geo->stride)
+        goto out;
+    for (uint64_t y = geo->first_row + 1; y + 1 < geo->height && *count < limit; y++)
+    {
+        if (fread(next, 1, geo->stride, fptr) != geo->stride)
+            goto out;
+        *count += adaptive_select_row(prev, cur, next, geo->row_bytes, threshold, sel);
+        unsigned char *tmp = prev;
+        prev = cur;
+        cur = next;
+        next = tmp;
+    }
+    ret = 0;
+
+out:
+    free(rows);
+    if (fseeko(fptr, start, SEEK_SET) != 0)
+        ret = -1;
+    return ret;
+}
@@ -0,0 +1,45 @@
+/* Name : Shobharaj H L
+   Date : 12/11/2025
+   Description : LSB_IMAGE_STEGANOGRAPHY */
+#ifndef ADAPTIVE_H
+#define ADAPTIVE_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Content adaptive embedding: payload bits only go into bytes whose
+ * neighbours (left/right pixel, row above/below, same channel) differ
+ * by at least a threshold. Only the upper 7 bits of the neighbours are
+ * looked at, so the decoder rebuilds the same selection from the stego
+ * image alone.
+ */
+
+#define ADAPTIVE_DEFAULT_THRESHOLD 8
+
+/* Rows of a 24 bpp BMP as seen from the data after its 54 byte header */
+typedef struct AdaptiveGeometry
+{
+    size_t stride;//bytes per row including padding
+    size_t row_bytes;//pixel bytes per row (width * 3)
+    uint64_t height;
+    uint64_t first_row;//first whole row after the sequential header bits
+} AdaptiveGeometry;
+
+/* Image bytes taken by the sequential header: magic, threshold, extn size, extn, file size */
+uint64_t adaptive_header_len(const char *extn);
+
+/* Fill geometry from the BMP header, header_len is counted from byte 54 */
+int adaptive_geometry(const char *bmp_header, uint64_t header_len, AdaptiveGeometry *geo);
+
+/* Mark (0xFF) the bytes of cur that may carry payload, returns how many */
+size_t adaptive_select_row(const unsigned char *prev, const unsigned char *cur, const unsigned char *next,
+                           size_t row_bytes, unsigned char threshold, unsigned char *sel);
+
+/* Count selectable bytes (up to limit) of the seekable pixel data starting at the
+   current position of fptr, which is restored. -1 if it cannot seek or read */
+int adaptive_capacity(FILE *fptr, const AdaptiveGeometry *geo, unsigned char threshold, uint64_t limit,
+                      uint64_t *count);
+
+#endif
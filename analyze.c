@@ -0,0 +1,447 @@
+/* Name : Shobharaj H L
+   Date : 12/11/2025
+   Description : LSB_IMAGE_STEGANOGRAPHY */
+#define _FILE_OFFSET_BITS 64
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <errno.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "encode.h"
+#include "analyze.h"
+#include "png.h"
+#include "stream.h"
+#include "typese.h"
+#include "common.h"
+
+/* Embedding likelihood above which an image is flagged */
+#define ANALYZE_FLAG_SCORE 0.95
+
+/* ---------------------------------------------------------------
+ * 📈 Regularized lower incomplete gamma P(a, x)
+ * --------------------------------------------------------------- */
+static double gamma_p(double a, double x)
+{
+    if (x <= 0.0)
+        return 0.0;
+
+    double log_prefix = -x + a * log(x) - lgamma(a);
+
+    if (x < a + 1.0)
+    {
+        // Series expansion
+        double ap = a, del = 1.0 / a, sum = del;
+        for (int n = 0; n < 1000 && fabs(del) > fabs(sum) * 1e-15; n++)
+        {
+            ap += 1.0;
+            del *= x / ap;
+            sum += del;
+        }
+        return sum * exp(log_prefix);
+    }
+
+    // Continued fraction for Q(a, x), modified Lentz
+    double b = x + 1.0 - a, c = 1.0 / 1e-300, d = 1.0 / b, h = d;
+    for (int i = 1; i < 1000; i++)
+    {
+        double an = -i * (i - a);
+        b += 2.0;
+        d = an * d + b;
+        if (fabs(d) < 1e-300)
+            d = 1e-300;
+        c = b + an / c;
+        if (fabs(c) < 1e-300)
+            c = 1e-300;
+        d = 1.0 / d;
+        double del = d * c;
+        h *= del;
+        if (fabs(del - 1.0) < 1e-15)
+            break;
+    }
+    return 1.0 - exp(log_prefix) * h;
+}
+
+/* ---------------------------------------------------------------
+ * 🧪 Chi-square attack on one histogram
+ * --------------------------------------------------------------- */
+double chi_square_lsb_score(const uint64_t *hist)
+{
+    double chi2 = 0.0;
+    int pairs = 0;
+
+    for (int k = 0; k < 128; k++)
+    {
+        double expected = (hist[2 * k] + hist[2 * k + 1]) / 2.0;
+        if (expected < ANALYZE_MIN_EXPECTED)
+            continue;
+        double d = hist[2 * k] - expected;
+        chi2 += d * d / expected;
+        pairs++;
+    }
+
+    if (pairs < 2)
+        return 0.0;
+
+    // Probability that pairs are this even by chance: high means embedded
+    return 1.0 - gamma_p((pairs - 1) / 2.0, chi2 / 2.0);
+}
+
+/* ---------------------------------------------------------------
+ * 📊 Histogram kernel: two banks so neighbouring pixels that hit
+ *    the same bin do not serialize on one counter
+ * --------------------------------------------------------------- */
+static void histogram_row(const unsigned char *p, size_t npix, uint32_t bank[2][3][256])
+{
+    size_t i = 0;
+    for (; i + 1 < npix; i += 2, p += 6)
+    {
+        bank[0][0][p[0]]++;
+        bank[0][1][p[1]]++;
+        bank[0][2][p[2]]++;
+        bank[1][0][p[3]]++;
+        bank[1][1][p[4]]++;
+        bank[1][2][p[5]]++;
+    }
+    if (i < npix)
+    {
+        bank[0][0][p[0]]++;
+        bank[0][1][p[1]]++;
+        bank[0][2][p[2]]++;
+    }
+}
+
+static void flush_banks(uint32_t bank[2][3][256], uint64_t hist[3][256])
+{
+    for (int c = 0; c < 3; c++)
+        for (int v = 0; v < 256; v++)
+            hist[c][v] += bank[0][c][v] + bank[1][c][v];
+    memset(bank, 0, 2 * 3 * 256 * sizeof(uint32_t));
+}
+
+/* ---------------------------------------------------------------
+ * 🪄 Check for one of our magic strings at the start of pixel data
+ * --------------------------------------------------------------- */
+static int has_magic_string(const unsigned char *data, size_t len)
+{
+    char magic[sizeof(MAGIC_STRING)];
+    size_t magic_len = strlen(MAGIC_STRING);
+    if (len < magic_len * 8)
+        return 0;
+
+    for (size_t i = 0; i < magic_len; i++)
+    {
+        unsigned char ch = 0;
+        for (int b = 0; b < 8; b++)
+            ch = (ch << 1) | (data[i * 8 + b] & 1);
+        magic[i] = ch;
+    }
+    magic[magic_len] = '\0';
+
+    return strcmp(magic, MAGIC_STRING) == 0 || strcmp(magic, MAGIC_STRING_ADAPTIVE) == 0 ||
+           strcmp(magic, MAGIC_STRING_FEC) == 0;
+}
+
+/* ---------------------------------------------------------------
+ * 🔎 Analyse one image in a single forward pass
+ * --------------------------------------------------------------- */
+Status analyze_image(const char *fname, AnalyzeResult *result)
+{
+    unsigned char header[BMP_HEADER_SIZE];
+    int32_t width, height;
+    uint32_t offset;
+    uint16_t bpp;
+
+    memset(result, 0, sizeof(*result));
+    result->fname = fname;
+
+    // Opened in two steps so a missing file is not reported as a bad PNG
+    FILE *fptr = open_input_stream(fname);
+    if (fptr == NULL)
+    {
+        result->error = "cannot open";
+        result->error_errno = errno;
+        return e_failure;
+    }
+    if (is_png_name(fname) && (fptr = png_input_stream(fptr)) == NULL)
+    {
+        result->error = "not a readable 8 bit RGB PNG";
+        return e_failure;
+    }
+
+    size_t got = fread(header, 1, BMP_HEADER_SIZE, fptr);
+    if (got != BMP_HEADER_SIZE || header[0] != 'B' || header[1] != 'M')
+    {
+        if (ferror(fptr))
+        {
+            result->error = "read failed";
+            result->error_errno = errno;
+        }
+        else
+            result->error = got >= 2 && header[0] == 'B' && header[1] == 'M' ? "BMP header is truncated" : "not a BMP";
+        fclose(fptr);
+        return e_failure;
+    }
+
+    memcpy(&offset, header + 10, sizeof(offset));
+    memcpy(&width, header + 18, sizeof(width));
+    memcpy(&height, header + 22, sizeof(height));
+    memcpy(&bpp, header + 28, sizeof(bpp));
+    if (height < 0)
+        height = -height;
+
+    if (bpp != 24 || width <= 0 || height == 0 || offset < BMP_HEADER_SIZE)
+    {
+        result->error = bpp != 24 ? "only 24 bpp BMPs are supported" : "corrupt BMP header";
+        fclose(fptr);
+        return e_failure;
+    }
+    result->width = width;
+    result->height = height;
+
+    // Reach pixel data by reading, like the encoder does
+    for (uint32_t skip = offset - BMP_HEADER_SIZE; skip > 0; skip--)
+    {
+        if (fgetc(fptr) == EOF)
+        {
+            result->error = ferror(fptr) ? "read failed" : "truncated before the pixel data";
+            result->error_errno = ferror(fptr) ? errno : 0;
+            fclose(fptr);
+            return e_failure;
+        }
+    }
+
+    size_t stride = bmp_row_stride((const char *)header);
+    size_t rows_per_chunk = stride >= ANALYZE_CHUNK_SIZE ? 1 : ANALYZE_CHUNK_SIZE / stride;
+    unsigned char *buffer = malloc(rows_per_chunk * stride);
+    uint64_t (*hist)[3][256] = calloc(ANALYZE_REGIONS, sizeof(*hist));
+    uint32_t (*bank)[3][256] = calloc(2, sizeof(*bank));
+    if (!buffer || !hist || !bank)
+    {
+        result->error = "out of memory";
+        free(buffer);
+        free(hist);
+        free(bank);
+        fclose(fptr);
+        return e_failure;
+    }
+
+    Status ret = e_success;
+    int64_t row = 0;
+    while (row < height)
+    {
+        size_t rows = rows_per_chunk;
+        if ((int64_t)rows > height - row)
+            rows = height - row;
+
+        if (fread(buffer, 1, rows * stride, fptr) != rows * stride)
+        {
+            result->error = ferror(fptr) ? "read failed" : "pixel data is truncated";
+            result->error_errno = ferror(fptr) ? errno : 0;
+            ret = e_failure;
+            break;
+        }
+
+        if (row == 0)
+            result->has_magic = has_magic_string(buffer, rows * stride);
+
+        int region = row * ANALYZE_REGIONS / height;
+        for (size_t r = 0; r < rows; r++, row++)
+        {
+            int row_region = row * ANALYZE_REGIONS / height;
+            if (row_region != region)
+            {
+                flush_banks(bank, hist[region]);
+                region = row_region;
+            }
+            histogram_row(buffer + r * stride, width, bank);
+        }
+        flush_banks(bank, hist[region]);
+    }
+
+    if (ret == e_success)
+    {
+        uint64_t total[3][256] = { { 0 } };
+        uint64_t pooled[256];
+
+        for (int g = 0; g < ANALYZE_REGIONS; g++)
+        {
+            memset(pooled, 0, sizeof(pooled));
+            for (int c = 0; c < 3; c++)
+            {
+                for (int v = 0; v < 256; v++)
+                {
+                    total[c][v] += hist[g][c][v];
+                    pooled[v] += hist[g][c][v];
+                }
+            }
+            result->region_score[g] = chi_square_lsb_score(pooled);
+        }
+
+        memset(pooled, 0, sizeof(pooled));
+        for (int c = 0; c < 3; c++)
+        {
+            result->channel_score[c] = chi_square_lsb_score(total[c]);
+            for (int v = 0; v < 256; v++)
+                pooled[v] += total[c][v];
+        }
+        result->score = chi_square_lsb_score(pooled);
+    }
+
+    free(buffer);
+    free(hist);
+    free(bank);
+    fclose(fptr);
+    return ret;
+}
+
+/* ---------------------------------------------------------------
+ * 🖨️ Print one result as a single line
+ * --------------------------------------------------------------- */
+static void print_result(const AnalyzeResult *result, Status status)
+{
+    static const char channel_name[3] = {'B', 'G', 'R'};
+    char line[1024];
+    char trigger[64] = "";
+    int len;
+
+    if (status != e_success)
+    {
+        if (result->error_errno)
+            printf("❌ %s: %s: %s\n", result->fname, result->error, strerror(result->error_errno));
+        else
+            printf("❌ %s: %s\n", result->fname, result->error);
+        return;
+    }
+
+    // A short secret only saturates the first bands or one channel, so any of them flags the image
+    if (result->score >= ANALYZE_FLAG_SCORE)
+        snprintf(trigger, sizeof(trigger), "whole image");
+    for (int c = 0; c < 3 && !trigger[0]; c++)
+        if (result->channel_score[c] >= ANALYZE_FLAG_SCORE)
+            snprintf(trigger, sizeof(trigger), "channel %c", channel_name[c]);
+    for (int g = 0, n = 0; g < ANALYZE_REGIONS && (n > 0 || !trigger[0]); g++)
+        if (result->region_score[g] >= ANALYZE_FLAG_SCORE)
+            n += snprintf(trigger + n, sizeof(trigger) - n, n ? ",%d" : "region %d", g);
+
+    len = snprintf(line, sizeof(line), "%s %s: score %.3f (B %.3f G %.3f R %.3f) regions [",
+                   trigger[0] ? "⚠️ " : "✅",
+                   result->fname, result->score,
+                   result->channel_score[0], result->channel_score[1], result->channel_score[2]);
+    for (int g = 0; g < ANALYZE_REGIONS && len < (int)sizeof(line); g++)
+        len += snprintf(line + len, sizeof(line) - len, g ? " %.2f" : "%.2f", result->region_score[g]);
+    if (len < (int)sizeof(line))
+        snprintf(line + len, sizeof(line) - len, "]%s%s%s\n", trigger[0] ? " 🚩 " : "", trigger,
+                 result->has_magic ? " 🪄 magic string" : "");
+
+    // One call per image so lines from different threads do not interleave
+    fputs(line, stdout);
+}
+
+/* Work shared by the analysis threads */
+typedef struct AnalyzeJobs
+{
+    char **fnames;
+    size_t count;
+    size_t next;
+} AnalyzeJobs;
+
+static void *analyze_worker(void *arg)
+{
+    AnalyzeJobs *jobs = arg;
+    AnalyzeResult result;
+
+    for (;;)
+    {
+        size_t i = __atomic_fetch_add(&jobs->next, 1, __ATOMIC_RELAXED);
+        if (i >= jobs->count)
+            break;
+        print_result(&result, analyze_image(jobs->fnames[i], &result));
+    }
+    return NULL;
+}
+
+/* ---------------------------------------------------------------
+ * 📁 Analyse a file, or every .bmp/.png in a directory
+ * --------------------------------------------------------------- */
+Status run_analyze(const char *path, int threads)
+{
+    struct stat st;
+    AnalyzeJobs jobs = { NULL, 0, 0 };
+    size_t capacity = 0;
+
+    if (stat(path, &st) != 0)
+    {
+        perror("stat");
+        return e_failure;
+    }
+
+    if (!S_ISDIR(st.st_mode))
+    {
+        AnalyzeResult result;
+        Status ret = analyze_image(path, &result);
+        print_result(&result, ret);
+        return ret;
+    }
+
+    DIR *dir = opendir(path);
+    if (dir == NULL)
+    {
+        perror("opendir");
+        return e_failure;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        size_t len = strlen(entry->d_name);
+        if (len < 4 || (strcmp(entry->d_name + len - 4, ".bmp") != 0 && strcmp(entry->d_name + len - 4, PNG_EXTN) != 0))
+            continue;
+
+        if (jobs.count == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 64;
+            char **grown = realloc(jobs.fnames, capacity * sizeof(char *));
+            if (!grown)
+                break;
+            jobs.fnames = grown;
+        }
+
+        char *fname = malloc(strlen(path) + len + 2);
+        if (!fname)
+            break;
+        sprintf(fname, "%s/%s", path, entry->d_name);
+        jobs.fnames[jobs.count++] = fname;
+    }
+    closedir(dir);
+
+    if (threads <= 0)
+        threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads <= 0)
+        threads = 1;
+    if ((size_t)threads > jobs.count)
+        threads = jobs.count ? jobs.count : 1;
+
+    printf("🔬 Analysing %zu images with %d threads\n", jobs.count, threads);
+
+    pthread_t tids[threads];
+    int started = 0;
+    for (; started < threads; started++)
+        if (pthread_create(&tids[started], NULL, analyze_worker, &jobs) != 0)
+            break;
+
+    // Fall back to this thread if none could be started
+    if (started == 0)
+        analyze_worker(&jobs);
+    for (int i = 0; i < started; i++)
+        pthread_join(tids[i], NULL);
+
+    for (size_t i = 0; i < jobs.count; i++)
+        free(jobs.fnames[i]);
+    free(jobs.fnames);
+    return e_success;
+}
@@ -0,0 +1,43 @@
+/* Name : Shobharaj H L
+   Date : 12/11/2025
+   Description : LSB_IMAGE_STEGANOGRAPHY */
+#ifndef ANALYZE_H
+#define ANALYZE_H
+
+#include "typese.h" // Contains user defined types
+
+/*
+ * LSB steganalysis: chi-square attack on the pairs of values
+ * (2k, 2k+1) of each colour channel. Sequential LSB embedding
+ * evens out each pair, which the test reports as a score near 1.
+ */
+
+#define ANALYZE_REGIONS 8 // horizontal bands, in file (pixel data) order
+#define ANALYZE_CHUNK_SIZE (1024 * 1024) // pixel bytes read at a time
+#define ANALYZE_MIN_EXPECTED 4.0 // pairs with fewer samples are skipped
+
+typedef struct AnalyzeResult
+{
+    const char *fname;//image being analysed
+    int width, height;
+    double score;//embedding likelihood, all channels pooled
+    double channel_score[3];//B, G, R
+    double region_score[ANALYZE_REGIONS];//per band, all channels pooled
+    int has_magic;//1 if our own MAGIC_STRING is present
+    const char *error;//why the image could not be analysed, NULL on success
+    int error_errno;//errno behind error, 0 if it is a format problem
+} AnalyzeResult;
+
+
+/* Analysis function prototype */
+
+/* Analyse one 24 bpp BMP or 8 bit RGB PNG */
+Status analyze_image(const char *fname, AnalyzeResult *result);
+
+/* Chi-square embedding likelihood from a 256 bin histogram */
+double chi_square_lsb_score(const uint64_t *hist);
+
+/* Analyse a file or every .bmp/.png in a directory using threads */
+Status run_analyze(const char *path, int threads);
+
+#endif
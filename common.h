@@ -4,4 +4,17 @@
 /* Magic string to identify whether stegged or not */
 #define MAGIC_STRING "#*!@#$()"
 
+/* Same length, marks content adaptive embedding (threshold byte follows) */
+#define MAGIC_STRING_ADAPTIVE "#*!@#${}"
+
+/* Same length, marks Reed-Solomon protected data; at least 7 bits away
+   from the others, so it is still recognised with FEC_MAGIC_TOLERANCE flips */
+#define MAGIC_STRING_FEC "#*!@#$WV"
+#define FEC_MAGIC_TOLERANCE 3
+
+/* FEC layout: nsym byte stored FEC_PARAM_COPIES times, then one codeword
+   holding extn length, extn (4 bytes, zero padded) and 32 bit size */
+#define FEC_PARAM_COPIES 3
+#define FEC_HEADER_SIZE 9
+
 #endif
@@ -0,0 +1,199 @@
+/* Name : Shobharaj H L
+   Date : 12/11/2025
+   Description : LSB_IMAGE_STEGANOGRAPHY */
+#define _FILE_OFFSET_BITS 64
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "encode.h"
+#include "cover.h"
+#include "stream.h"
+#include "png.h"
+#include "output.h"
+#include "typese.h"
+
+/* ---------------------------------------------------------------
+ * 🗂️ Parse the header and load the pixel plane once
+ * --------------------------------------------------------------- */
+Status prepare_cover(const char *fname, PreparedCover *cover)
+{
+    struct stat st;
+    unsigned char *data = NULL;
+    size_t data_size = 0;
+    FILE *fptr;
+
+    memset(cover, 0, sizeof(*cover));
+    cover->src_image_fname = fname;
+
+    // A PNG cover is decoded once and its BMP view becomes the pixel plane as is
+    if (is_png_name(fname))
+        fptr = png_load_bmp(fname, &data, &data_size) == e_success ? fmemopen(data, data_size, "r") : NULL;
+    else
+        fptr = open_input_stream(fname);
+    if (fptr == NULL)
+    {
+        perror("fopen");
+        fprintf(stderr, "❌ ERROR: Unable to open image file %s\n", fname);
+        free(data);
+        return e_failure;
+    }
+
+    cover->image_capacity = get_image_size_for_bmp(fptr, cover->bmp_header);
+
+    off_t file_size = -1;
+    if (data != NULL)
+        file_size = data_size;
+    else if (fstat(fileno(fptr), &st) == 0)
+        file_size = st.st_size;
+
+    if (cover->image_capacity == 0 || file_size <= BMP_HEADER_SIZE)
+    {
+        fclose(fptr);
+        free(data);
+        return e_failure;
+    }
+    cover->pixels_size = file_size - BMP_HEADER_SIZE;
+
+    // Map the whole file read-only and fault it in now, so embeds never touch the disk
+    void *map = data == NULL ? mmap(NULL, file_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fileno(fptr), 0)
+                             : MAP_FAILED;
+    if (map != MAP_FAILED)
+    {
+        data = map;
+        cover->mapped = 1;
+    }
+    else if (data == NULL)
+    {
+        // Not mappable: read it in behind a copy of the header, laid out like the file
+        data = malloc(file_size);
+        if (!data || fread(data + BMP_HEADER_SIZE, 1, cover->pixels_size, fptr) != cover->pixels_size)
+        {
+            free(data);
+            fclose(fptr);
+            return e_failure;
+        }
+        memcpy(data, cover->bmp_header, BMP_HEADER_SIZE);
+    }
+    cover->pixels = data + BMP_HEADER_SIZE;
+
+    fclose(fptr);
+    printf("🗂️  Cover %s prepared (%zu pixel bytes)\n", fname, cover->pixels_size);
+    return e_success;
+}
+
+/* ---------------------------------------------------------------
+ * 🧷 Embed one secret: read only the payload region of the cover
+ * --------------------------------------------------------------- */
+Status encode_prepared_cover(const PreparedCover *cover, EncodeInfo *encInfo)
+{
+    memcpy(encInfo->bmp_header, cover->bmp_header, BMP_HEADER_SIZE);
+    encInfo->image_capacity = cover->image_capacity;
+
+    // The encode steps read the shared plane through a read-only memory stream
+    encInfo->fptr_src_image = fmemopen(cover->pixels, cover->pixels_size, "r");
+    if (encInfo->fptr_src_image == NULL)
+        return e_failure;
+
+    Status ret = check_secret_fits(encInfo);
+    if (ret == e_success)
+        ret = encode_secret_fields(encInfo);
+    off_t used = ftello(encInfo->fptr_src_image);
+    fclose(encInfo->fptr_src_image);
+    encInfo->fptr_src_image = NULL;
+    if (ret != e_success || used < 0)
+        return e_failure;
+
+    // Everything after the payload goes out in one write from the plane
+    size_t rest = cover->pixels_size - used;
+    if (fwrite(cover->pixels + used, 1, rest, encInfo->fptr_stego_image) != rest)
+        return e_failure;
+
+    printf("✅ Secret %s embedded into %s\n", encInfo->secret_fname, encInfo->stego_image_fname);
+    return e_success;
+}
+
+/* ---------------------------------------------------------------
+ * 🧹 Release the pixel plane
+ * --------------------------------------------------------------- */
+void release_cover(PreparedCover *cover)
+{
+    if (cover->pixels == NULL)
+        return;
+    // pixels always sits right after the header of the mapped or malloc'ed file image
+    if (cover->mapped)
+        munmap(cover->pixels - BMP_HEADER_SIZE, cover->pixels_size + BMP_HEADER_SIZE);
+    else
+        free(cover->pixels - BMP_HEADER_SIZE);
+    cover->pixels = NULL;
+}
+
+/* ---------------------------------------------------------------
+ * 📚 Prepare one cover and embed every <secret> <output> pair
+ * --------------------------------------------------------------- */
+Status do_batch_encoding(const char *cover_fname, int npairs, char *pairs[], const EncodeInfo *options)
+{
+    PreparedCover cover;
+    IoStats stats;
+    int failed = 0;
+
+    printf("\n📚 Starting Batch Encoding Process...\n");
+    io_stats_start(&stats);
+
+    if (prepare_cover(cover_fname, &cover) != e_success)
+        return e_failure;
+
+    for (int i = 0; i < npairs; i++)
+    {
+        EncodeInfo encInfo = *options;
+
+        encInfo.src_image_fname = (char *)cover_fname;
+        encInfo.secret_fname = pairs[2 * i];
+        encInfo.stego_image_fname = pairs[2 * i + 1];
+
+        encInfo.fptr_secret = open_input_stream(encInfo.secret_fname);
+        if (encInfo.fptr_secret == NULL)
+        {
+            perror("fopen");
+            fprintf(stderr, "❌ ERROR: Unable to open secret file %s\n", encInfo.secret_fname);
+            failed++;
+            continue;
+        }
+
+        // Every BMP output is exactly as large as the cover file
+        encInfo.fptr_stego_image = open_image_output(encInfo.stego_image_fname,
+                                                     BMP_HEADER_SIZE + cover.pixels_size, encInfo.output_flags);
+        if (encInfo.fptr_stego_image == NULL)
+        {
+            perror("fopen");
+            fprintf(stderr, "❌ ERROR: Unable to open output file %s\n", encInfo.stego_image_fname);
+            fclose(encInfo.fptr_secret);
+            failed++;
+            continue;
+        }
+
+        Status ret = encode_prepared_cover(&cover, &encInfo);
+
+        fclose(encInfo.fptr_secret);
+        if (fclose(encInfo.fptr_stego_image) != 0)
+            ret = e_failure;
+
+        if (ret != e_success)
+        {
+            printf("❌ Encoding %s failed.\n", encInfo.secret_fname);
+            if (!is_stream_name(encInfo.stego_image_fname))
+                remove(encInfo.stego_image_fname);
+            failed++;
+        }
+        else if (options->output_flags & OUTPUT_STATS)
+            io_stats_add_output(&stats, encInfo.stego_image_fname);
+    }
+
+    release_cover(&cover);
+    printf("\n📚 Batch done: %d of %d secrets embedded.\n", npairs - failed, npairs);
+    if (options->output_flags & OUTPUT_STATS)
+        io_stats_print(&stats);
+    return failed ? e_failure : e_success;
+}
@@ -0,0 +1,42 @@
+/* Name : Shobharaj H L
+   Date : 12/11/2025
+   Description : LSB_IMAGE_STEGANOGRAPHY */
+#ifndef COVER_H
+#define COVER_H
+
+#include "typese.h" // Contains user defined types
+#include "encode.h"
+
+/*
+ * A cover parsed and loaded once, then used read-only by any number
+ * of embeds (also from several threads). Each embed only reads the
+ * pixel bytes that carry the payload; the rest is written straight
+ * from the shared pixel plane.
+ */
+
+typedef struct PreparedCover
+{
+    const char *src_image_fname;//cover file name
+    char bmp_header[BMP_HEADER_SIZE];//parsed once
+    uint64_t image_capacity;//as computed by get_image_size_for_bmp
+    unsigned char *pixels;//everything after the header, read-only
+    size_t pixels_size;
+    int mapped;//1 if the file is mmap'ed, 0 if it (or a decoded PNG) is malloc'ed; pixels follows its header
+} PreparedCover;
+
+
+/* Prepared cover function prototype */
+
+/* Parse and load a cover once */
+Status prepare_cover(const char *fname, PreparedCover *cover);
+
+/* Embed the secret in encInfo (fptr_secret, fptr_stego_image and options set) */
+Status encode_prepared_cover(const PreparedCover *cover, EncodeInfo *encInfo);
+
+/* Release the pixel plane */
+void release_cover(PreparedCover *cover);
+
+/* Embed several secrets into one cover: pairs holds <secret> <output> names */
+Status do_batch_encoding(const char *cover_fname, int npairs, char *pairs[], const EncodeInfo *options);
+
+#endif
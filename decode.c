@@ -1,11 +1,15 @@
 /* Name : Shobharaj H L
    Date : 12/11/2025
    Description : LSB_IMAGE_STEGANOGRAPHY */
+#define _FILE_OFFSET_BITS 64 // 64-bit off_t, fseeko and ftello for covers over 4 GB
 #include <stdio.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include "decode.h"
+#include "adaptive.h"
+#include "rs.h"
+#include "stream.h"
 #include "typesd.h"
 #include "common.h"
 
@@ -55,8 +59,22 @@ Statusd decode_magic_string(char *magic_string, EncodeInfod *encInfod)
     if (decode_data_from_image(magic_string, strlen(MAGIC_STRING), encInfod->fptr_stego_image) != d_success)
         return d_failure;
 
-    if (strcmp(MAGIC_STRING, magic_string) != 0)
-        return d_failure;
+    // The adaptive and FEC magic strings have the same length
+    encInfod->adaptive = 0;
+    encInfod->fec = 0;
+    if (strcmp(MAGIC_STRING_ADAPTIVE, magic_string) == 0)
+        encInfod->adaptive = 1;
+    else if (strcmp(MAGIC_STRING, magic_string) != 0)
+    {
+        // The FEC magic string is accepted with a few flipped bits
+        int flipped = 0;
+        for (size_t i = 0; i < strlen(MAGIC_STRING_FEC); i++)
+            flipped += __builtin_popcount((unsigned char)(magic_string[i] ^ MAGIC_STRING_FEC[i]));
+        if (flipped > FEC_MAGIC_TOLERANCE)
+            return d_failure;
+        encInfod->fec = 1;
+        strcpy(magic_string, MAGIC_STRING_FEC);
+    }
 
     printf("🪄 Magic string verified: %s\n", magic_string);
     return d_success;
@@ -88,11 +106,43 @@ Statusd decode_extn_size(int *size, EncodeInfod *encInfod)
     if (decode_size_from_lsb(size, image_buffer) != d_success)
         return d_failure;
 
+    // Guard against a damaged header before the extension is copied
+    if (*size < 0 || *size >= MAX_FILE_SUFFIX)
+    {
+        fprintf(stderr, "❌ ERROR: Invalid extension size %d\n", *size);
+        return d_failure;
+    }
+
     printf("📏 Decoded extension size: %d bytes\n", *size);
     return d_success;
 }
 
 
+ //Function: open_output_file
+ // Purpose : Create the output file named after the decoded extension
+static Statusd open_output_file(EncodeInfod *encInfod)
+{
+    // "-" writes the secret to stdout, so no extension is added
+    if (is_stream_name(encInfod->buf))
+        encInfod->out_fptr = stdout_data_stream();
+    else
+    {
+        size_t len = strlen(encInfod->buf);
+        memcpy(encInfod->buf + len, encInfod->extn_secret_file, strlen(encInfod->extn_secret_file) + 1);
+        encInfod->out_fptr = fopen(encInfod->buf, "wb");
+    }
+    if (encInfod->out_fptr == NULL)
+    {
+        perror("fopen");
+        fprintf(stderr, "❌ ERROR: Unable to open file %s\n", encInfod->buf);
+        return d_failure;
+    }
+
+    printf("📂 Decoded file extension: %s\n", encInfod->extn_secret_file);
+    printf("💾 Output file created: %s\n", encInfod->buf);
+    return d_success;
+}
+
  //Function: decode_extn
  // Purpose : Decode and prepare output filename
 Statusd decode_extn(int *size, EncodeInfod *encInfod)
@@ -105,26 +155,13 @@ Statusd decode_extn(int *size, EncodeInfod *encInfod)
     extn[*size] = '\0';
     strcpy(encInfod->extn_secret_file, extn);
 
-    if (encInfod->buf != NULL)
-        strcat(encInfod->buf, extn);
-
-    encInfod->out_fptr = fopen(encInfod->buf, "wb");
-    if (encInfod->out_fptr == NULL)
-    {
-        perror("fopen");
-        fprintf(stderr, "❌ ERROR: Unable to open file %s\n", encInfod->buf);
-        return d_failure;
-    }
-
-    printf("📂 Decoded file extension: %s\n", extn);
-    printf("💾 Output file created: %s\n", encInfod->buf);
-    return d_success;
+    return open_output_file(encInfod);
 }
 
 
  //Function: decode_secret_file_size
  // Purpose : Decode size of hidden secret file
-Statusd decode_secret_file_size(long *file_size, EncodeInfod *encInfod)
+Statusd decode_secret_file_size(off_t *file_size, EncodeInfod *encInfod)
 {
     char image_buffer[32];
 
@@ -138,8 +175,8 @@ Statusd decode_secret_file_size(long *file_size, EncodeInfod *encInfod)
     if (decode_size_from_lsb(&temp_size, image_buffer) != d_success)
         return d_failure;
 
-    *file_size = temp_size;
-    printf("📦 Decoded secret file size: %ld bytes\n", *file_size);
+    *file_size = (uint32_t)temp_size; // stored unsigned, up to 4 GB
+    printf("📦 Decoded secret file size: %lld bytes\n", (long long)*file_size);
     return d_success;
 }
 
@@ -148,51 +185,329 @@ Statusd decode_secret_file_size(long *file_size, EncodeInfod *encInfod)
  
 Statusd decode_secret_file_data(EncodeInfod *encInfod)
 {
-    long size = encInfod->size_secret_file;
-    char *secret_data = malloc(size);
-    if (!secret_data)
+    // Decode in chunks so large secrets are not held in memory
+    char *secret_data = malloc(STREAM_CHUNK_SIZE);
+    char *image_buffer = malloc(STREAM_CHUNK_SIZE * 8);
+    if (!secret_data || !image_buffer)
     {
         fprintf(stderr, "❌ ERROR: Memory allocation failed\n");
+        free(secret_data);
+        free(image_buffer);
         return d_failure;
     }
 
-    char image_buffer[8];
-
-    for (long i = 0; i < size; i++)
+    off_t remaining = encInfod->size_secret_file;
+    while (remaining > 0)
     {
-        if (fread(image_buffer, 1, 8, encInfod->fptr_stego_image) != 8)
+        size_t chunk = remaining < STREAM_CHUNK_SIZE ? (size_t)remaining : STREAM_CHUNK_SIZE;
+
+        if (fread(image_buffer, 1, chunk * 8, encInfod->fptr_stego_image) != chunk * 8)
         {
-            fprintf(stderr, "❌ ERROR: Unable to read 8 bytes from image\n");
+            fprintf(stderr, "❌ ERROR: Unable to read %zu bytes from image\n", chunk * 8);
             free(secret_data);
+            free(image_buffer);
             return d_failure;
         }
 
-        if (decode_byte_from_lsb(&secret_data[i], image_buffer) != d_success)
+        for (size_t i = 0; i < chunk; i++)
+            decode_byte_from_lsb(&secret_data[i], image_buffer + i * 8);
+
+        if (fwrite(secret_data, 1, chunk, encInfod->out_fptr) != chunk)
         {
+            fprintf(stderr, "❌ ERROR: Unable to write all decoded data to output file\n");
             free(secret_data);
+            free(image_buffer);
             return d_failure;
         }
+        remaining -= chunk;
     }
+    free(image_buffer);
 
-    if (fwrite(secret_data, 1, size, encInfod->out_fptr) != size)
+    fclose(encInfod->out_fptr);
+    encInfod->out_fptr = NULL;
+    free(secret_data);
+
+    printf("✅ Secret file data successfully decoded and written!\n");
+    return d_success;
+}
+
+
+//Function: decode_adaptive_threshold
+ // Purpose : Decode the threshold byte that follows the adaptive magic string
+Statusd decode_adaptive_threshold(EncodeInfod *encInfod)
+{
+    char threshold[2];
+
+    if (decode_data_from_image(threshold, 1, encInfod->fptr_stego_image) != d_success)
+        return d_failure;
+
+    encInfod->threshold = threshold[0];
+    printf("🎚️  Decoded adaptive threshold: %u\n", encInfod->threshold);
+    return d_success;
+}
+
+//Function: decode_secret_file_data_adaptive
+ // Purpose : Rebuild the high variance selection and read bits from it
+Statusd decode_secret_file_data_adaptive(EncodeInfod *encInfod)
+{
+    AdaptiveGeometry geo;
+
+    // Bytes already used by the sequential header fields
+    uint64_t header_len = adaptive_header_len(encInfod->extn_secret_file);
+
+    if (adaptive_geometry(encInfod->bmp_header, header_len, &geo) != 0 || geo.first_row + 2 >= geo.height)
+        return d_failure;
+
+    unsigned char *rows = malloc(geo.stride * 3 + geo.row_bytes);
+    char *secret_data = malloc(STREAM_CHUNK_SIZE);
+    if (!rows || !secret_data)
     {
-        fprintf(stderr, "❌ ERROR: Unable to write all decoded data to output file\n");
+        fprintf(stderr, "❌ ERROR: Memory allocation failed\n");
+        free(rows);
         free(secret_data);
         return d_failure;
     }
+    unsigned char *prev = rows, *cur = rows + geo.stride, *next = rows + 2 * geo.stride;
+    unsigned char *sel = rows + 3 * geo.stride;
+
+    off_t remaining = encInfod->size_secret_file;
+    size_t secret_len = 0;
+    unsigned char ch = 0;
+    int bit = 0;
+    Statusd ret = d_failure;
+
+    // Skip up to the first whole row, it only serves as the row above
+    for (uint64_t skip = geo.first_row * geo.stride - header_len; skip > 0; )
+    {
+        size_t chunk = skip < geo.stride ? skip : geo.stride;
+        if (fread(rows, 1, chunk, encInfod->fptr_stego_image) != chunk)
+            goto out;
+        skip -= chunk;
+    }
+
+    if (fread(prev, 1, geo.stride, encInfod->fptr_stego_image) != geo.stride ||
+        fread(cur, 1, geo.stride, encInfod->fptr_stego_image) != geo.stride)
+        goto out;
+
+    for (uint64_t y = geo.first_row + 1; y + 1 < geo.height && remaining > 0; y++)
+    {
+        if (fread(next, 1, geo.stride, encInfod->fptr_stego_image) != geo.stride)
+            goto out;
+
+        adaptive_select_row(prev, cur, next, geo.row_bytes, encInfod->threshold, sel);
+
+        for (size_t x = 0; x < geo.row_bytes && remaining > 0; x++)
+        {
+            if (!sel[x])
+                continue;
+
+            ch = (ch << 1) | (cur[x] & 1);
+            if (++bit < 8)
+                continue;
+
+            secret_data[secret_len++] = ch;
+            bit = 0;
+            remaining--;
+            if (secret_len == STREAM_CHUNK_SIZE || remaining == 0)
+            {
+                if (fwrite(secret_data, 1, secret_len, encInfod->out_fptr) != secret_len)
+                    goto out;
+                secret_len = 0;
+            }
+        }
+
+        unsigned char *tmp = prev;
+        prev = cur;
+        cur = next;
+        next = tmp;
+    }
+
+    if (remaining > 0)
+    {
+        fprintf(stderr, "❌ ERROR: Image ended before the whole secret was decoded\n");
+        goto out;
+    }
 
     fclose(encInfod->out_fptr);
+    encInfod->out_fptr = NULL;
+    printf("✅ Secret file data successfully decoded from high variance pixels!\n");
+    ret = d_success;
+
+out:
+    free(rows);
     free(secret_data);
+    return ret;
+}
 
-    printf("✅ Secret file data successfully decoded and written!\n");
+//Function: decode_fec_params
+ // Purpose : Decode the parity count, voting bitwise over its copies
+Statusd decode_fec_params(EncodeInfod *encInfod)
+{
+    char params[FEC_PARAM_COPIES + 1];
+
+    if (decode_data_from_image(params, FEC_PARAM_COPIES, encInfod->fptr_stego_image) != d_success)
+        return d_failure;
+
+    unsigned char a = params[0], b = params[1], c = params[2];
+    encInfod->fec_nsym = (a & b) | (a & c) | (b & c);
+
+    if (encInfod->fec_nsym < 2 || encInfod->fec_nsym > RS_MAX_NSYM)
+    {
+        fprintf(stderr, "❌ ERROR: Invalid error correction level %d\n", encInfod->fec_nsym);
+        return d_failure;
+    }
+
+    printf("🛡️  Decoded error correction level: %d parity bytes per block\n", encInfod->fec_nsym);
+    return d_success;
+}
+
+//Function: decode_fec_header
+ // Purpose : Correct and parse extension and size, then create the output
+Statusd decode_fec_header(EncodeInfod *encInfod)
+{
+    char block[RS_BLOCK_SIZE + 1];
+    RsCode *code = malloc(sizeof(RsCode));
+    size_t n = FEC_HEADER_SIZE + encInfod->fec_nsym;
+
+    if (!code)
+        return d_failure;
+
+    if (decode_data_from_image(block, n, encInfod->fptr_stego_image) != d_success)
+    {
+        free(code);
+        return d_failure;
+    }
+
+    int fixed = rs_init(code, encInfod->fec_nsym) == 0 ? rs_correct(code, (uint8_t *)block, n) : -1;
+    free(code);
+
+    unsigned char *msg = (unsigned char *)block;
+    if (fixed < 0 || msg[0] >= MAX_FILE_SUFFIX)
+    {
+        fprintf(stderr, "❌ ERROR: Protected header is too damaged to correct\n");
+        return d_failure;
+    }
+    if (fixed > 0)
+        printf("🩹 Corrected %d header bytes\n", fixed);
+
+    memcpy(encInfod->extn_secret_file, msg + 1, msg[0]);
+    encInfod->extn_secret_file[msg[0]] = '\0';
+    encInfod->size_secret_file = ((uint32_t)msg[5] << 24) | (msg[6] << 16) | (msg[7] << 8) | msg[8];
+    printf("📦 Decoded secret file size: %lld bytes\n", (long long)encInfod->size_secret_file);
+
+    return open_output_file(encInfod);
+}
+
+//Function: decode_secret_file_data_fec
+ // Purpose : Decode Reed-Solomon blocks, correct them and write the data
+Statusd decode_secret_file_data_fec(EncodeInfod *encInfod)
+{
+    // Blocks are grouped so image bytes move in large reads
+    const size_t group = STREAM_CHUNK_SIZE / RS_BLOCK_SIZE;
+    RsCode *code = malloc(sizeof(RsCode));
+    char *coded = malloc(group * RS_BLOCK_SIZE);
+    char *image_bytes = malloc(group * RS_BLOCK_SIZE * 8);
+    size_t k = RS_BLOCK_SIZE - encInfod->fec_nsym;
+    size_t n = RS_BLOCK_SIZE;
+    long long fixed_total = 0, index = 0;
+    Statusd ret = d_failure;
+
+    if (!code || !coded || !image_bytes)
+    {
+        fprintf(stderr, "❌ ERROR: Memory allocation failed\n");
+        goto out;
+    }
+    if (rs_init(code, encInfod->fec_nsym) != 0)
+        goto out;
+
+    off_t remaining = encInfod->size_secret_file;
+    while (remaining > 0)
+    {
+        // Full blocks in this group, plus the shortened last one if it falls here
+        off_t full = remaining / k;
+        size_t blocks = full < (off_t)group ? (size_t)full : group;
+        size_t last = 0;
+        if (blocks < group && remaining % k)
+            last = remaining % k;
+        size_t coded_len = blocks * n + (last ? last + encInfod->fec_nsym : 0);
+
+        if (fread(image_bytes, 1, coded_len * 8, encInfod->fptr_stego_image) != coded_len * 8)
+        {
+            fprintf(stderr, "❌ ERROR: Unable to read %zu bytes from image\n", coded_len * 8);
+            goto out;
+        }
+        for (size_t i = 0; i < coded_len; i++)
+            decode_byte_from_lsb(&coded[i], image_bytes + i * 8);
+
+        // Whole blocks are corrected side by side, the shortened last one on its own
+        size_t bad;
+        long fixed = rs_correct_blocks(code, (uint8_t *)coded, blocks, &bad);
+        if (fixed >= 0 && last)
+        {
+            int fixed_last = rs_correct(code, (uint8_t *)coded + blocks * n, last + encInfod->fec_nsym);
+            bad = blocks;
+            fixed = fixed_last < 0 ? -1 : fixed + fixed_last;
+        }
+        if (fixed < 0)
+        {
+            fprintf(stderr, "❌ ERROR: Block %lld is too damaged to correct\n", index + (long long)bad);
+            goto out;
+        }
+        fixed_total += fixed;
+        index += blocks + (last ? 1 : 0);
+
+        for (size_t off = 0; off < coded_len; off += n)
+        {
+            size_t chunk = (coded_len - off < n ? coded_len - off : n) - encInfod->fec_nsym;
+
+            if (fwrite(coded + off, 1, chunk, encInfod->out_fptr) != chunk)
+            {
+                fprintf(stderr, "❌ ERROR: Unable to write all decoded data to output file\n");
+                goto out;
+            }
+            remaining -= chunk;
+        }
+    }
+    ret = d_success;
+
+out:
+    free(code);
+    free(coded);
+    free(image_bytes);
+    if (ret != d_success)
+        return d_failure;
+
+    fclose(encInfod->out_fptr);
+    encInfod->out_fptr = NULL;
+
+    if (fixed_total > 0)
+        printf("🩹 Corrected %lld damaged bytes in the secret data\n", fixed_total);
+    printf("✅ Protected secret file data successfully decoded and written!\n");
     return d_success;
 }
 
+//Function: probe_stego_image
+ // Purpose : Only check whether the image carries our magic string
+Statusd probe_stego_image(EncodeInfod *encInfod)
+{
+    char header[54];
+    char magic_string[strlen(MAGIC_STRING) + 1];
+
+    // Read past the BMP header instead of seeking so pipes work too
+    if (fread(header, 1, 54, encInfod->fptr_stego_image) != 54)
+        return d_failure;
+
+    return decode_magic_string(magic_string, encInfod);
+}
+
 
 Statusd do_decoding(EncodeInfod *encInfod)
 {
     printf("\n🔍 Starting decoding process...\n");
-    fseek(encInfod->fptr_stego_image, 54, SEEK_SET); // Skip BMP header
+
+    // Skip BMP header by reading it, so the stego image may be a pipe
+    if (fread(encInfod->bmp_header, 1, 54, encInfod->fptr_stego_image) != 54)
+        return d_failure;
 
     char magic_string[strlen(MAGIC_STRING) + 1];
 
@@ -202,23 +517,44 @@ Statusd do_decoding(EncodeInfod *encInfod)
         return d_failure;
     }
 
-    int extn_size;
-    if (decode_extn_size(&extn_size, encInfod) != d_success)
-        return d_failure;
+    if (encInfod->fec)
+    {
+        // Protected layout: everything after the magic string is Reed-Solomon coded
+        if (decode_fec_params(encInfod) != d_success)
+            return d_failure;
+        if (decode_fec_header(encInfod) != d_success)
+            return d_failure;
+        if (decode_secret_file_data_fec(encInfod) != d_success)
+            return d_failure;
+    }
+    else
+    {
+        if (encInfod->adaptive && decode_adaptive_threshold(encInfod) != d_success)
+            return d_failure;
 
-    if (decode_extn(&extn_size, encInfod) != d_success)
-        return d_failure;
+        int extn_size;
+        if (decode_extn_size(&extn_size, encInfod) != d_success)
+            return d_failure;
 
-    if (decode_secret_file_size(&encInfod->size_secret_file, encInfod) != d_success)
-        return d_failure;
+        if (decode_extn(&extn_size, encInfod) != d_success)
+            return d_failure;
 
-    if (decode_secret_file_data(encInfod) != d_success)
-        return d_failure;
+        if (decode_secret_file_size(&encInfod->size_secret_file, encInfod) != d_success)
+            return d_failure;
+
+        if (encInfod->adaptive)
+        {
+            if (decode_secret_file_data_adaptive(encInfod) != d_success)
+                return d_failure;
+        }
+        else if (decode_secret_file_data(encInfod) != d_success)
+            return d_failure;
+    }
 
     printf("🎉 Decoding completed successfully!\n");
     printf("------------------------------------------\n");
     printf("📁 Output File: %s\n", encInfod->buf);
-    printf("📄 File Size  : %ld bytes\n", encInfod->size_secret_file);
+    printf("📄 File Size  : %lld bytes\n", (long long)encInfod->size_secret_file);
     printf("------------------------------------------\n");
 
     return d_success;
@@ -16,20 +16,26 @@
 #define MAX_SECRET_BUF_SIZE 1
 #define MAX_IMAGE_BUF_SIZE (MAX_SECRET_BUF_SIZE * 8)
 #define MAX_FILE_SUFFIX 5
+#define STREAM_CHUNK_SIZE (64 * 1024) // secret bytes handled per write when streaming
 
 typedef struct EncodeInfod
 {
     /* Source Image info */
     char *src_image_fname;//To store the beautiful.bmp
     FILE *fptr_src_image;//to hold the beautiful.bmp offset
-    uint image_capacity;//to store the size
+    uint64_t image_capacity;//to store the size
     uint bits_per_pixel;
     char image_data[MAX_IMAGE_BUF_SIZE];//to store the readed 8 bytes
+    char bmp_header[54];//needed for the row layout in adaptive mode
 
     /* Secret File Info */
     
     char extn_secret_file[MAX_FILE_SUFFIX];//to store extension of secret file
-    long size_secret_file;//to store secret file size
+    int adaptive;//1 if the adaptive magic string was found
+    unsigned char threshold;//decoded adaptive threshold
+    int fec;//1 if the Reed-Solomon magic string was found
+    int fec_nsym;//decoded parity bytes per block
+    off_t size_secret_file;//to store secret file size
 
     /* Stego Image Info */
     char *stego_image_fname;//to store o/p file name
@@ -53,6 +59,9 @@ Statusd read_and_validate_decode_args(int argc,char *argv[], EncodeInfod *encInf
 Statusd do_decoding(EncodeInfod *encInfod);
 
 
+/* Check only for the magic string */
+Statusd probe_stego_image(EncodeInfod *encInfod);
+
 /* Store Magic String */
 Statusd decode_magic_string(char *magic_string, EncodeInfod *encInfod);
 
@@ -60,11 +69,26 @@ Statusd decode_magic_string(char *magic_string, EncodeInfod *encInfod);
 Statusd decode_extn(int *size, EncodeInfod *encInfod);
 
 /* Encode secret file size */
-Statusd decode_secret_file_size(long *file_size, EncodeInfod *encInfod);
+Statusd decode_secret_file_size(off_t *file_size, EncodeInfod *encInfod);
 
 /* Encode secret file data*/
 Statusd decode_secret_file_data(EncodeInfod *encInfod);
 
+/* Decode the adaptive threshold byte */
+Statusd decode_adaptive_threshold(EncodeInfod *encInfod);
+
+/* Decode secret file data from high variance bytes only */
+Statusd decode_secret_file_data_adaptive(EncodeInfod *encInfod);
+
+/* Decode the Reed-Solomon parity count by majority vote */
+Statusd decode_fec_params(EncodeInfod *encInfod);
+
+/* Decode and correct the protected extension and size, open output */
+Statusd decode_fec_header(EncodeInfod *encInfod);
+
+/* Decode and correct Reed-Solomon protected secret file data */
+Statusd decode_secret_file_data_fec(EncodeInfod *encInfod);
+
 /* Encode function, which does the real encoding */
 Statusd decode_data_from_image( char *data, int size, FILE *fptr_stego_image);
 
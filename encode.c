@@ -1,31 +1,48 @@
 /* Name : Shobharaj H L
    Date : 12/11/2025
    Description : LSB_IMAGE_STEGANOGRAPHY */
+#define _FILE_OFFSET_BITS 64 // 64-bit off_t, fseeko and ftello for covers over 4 GB
 #include <stdio.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <sys/stat.h>
 #include "encode.h"
+#include "adaptive.h"
+#include "rs.h"
+#include "stream.h"
+#include "png.h"
+#include "output.h"
 #include "typese.h"
 #include "common.h"
 
 /* ---------------------------------------------------------------
  * 🧠 Function: Get image size (for BMP)
  * --------------------------------------------------------------- */
-uint get_image_size_for_bmp(FILE *fptr_image)
+uint64_t get_image_size_for_bmp(FILE *fptr_image, char *header)
 {
-    uint width, height;
+    int32_t width, height;
+    uint64_t size;
 
-    // Seek to 18th byte where width starts
-    fseek(fptr_image, 18, SEEK_SET);
+    // Read the whole header forward so stdin works as a cover
+    if (fread(header, 1, BMP_HEADER_SIZE, fptr_image) != BMP_HEADER_SIZE)
+        return 0;
 
-    fread(&width, sizeof(int), 1, fptr_image);
-    fread(&height, sizeof(int), 1, fptr_image);
+    // Width starts at the 18th byte, height right after it
+    memcpy(&width, header + 18, sizeof(width));
+    memcpy(&height, header + 22, sizeof(height));
 
-    printf("🖼️  Image Dimensions: width = %u, height = %u\n", width, height);
+    // Negative height means a top-down BMP
+    if (height < 0)
+        height = -height;
 
-    rewind(fptr_image); // Reset file pointer
-    return width * height * 3; // 3 bytes per pixel (RGB)
+    printf("🖼️  Image Dimensions: width = %d, height = %d\n", width, height);
+
+    // 3 bytes per pixel (RGB), in 64 bits so multi-GB covers do not wrap
+    if (width <= 0 || __builtin_mul_overflow((uint64_t)width, (uint64_t)height, &size) ||
+        __builtin_mul_overflow(size, 3, &size))
+        return 0;
+    return size;
 }
 
 /* ---------------------------------------------------------------
@@ -33,7 +50,8 @@ uint get_image_size_for_bmp(FILE *fptr_image)
  * --------------------------------------------------------------- */
 Status open_files(EncodeInfo *encInfo)
 {
-    encInfo->fptr_src_image = fopen(encInfo->src_image_fname, "rb");
+    // "-" reads the cover from stdin, "fd:<n>" uses an inherited descriptor, PNG is decoded
+    encInfo->fptr_src_image = open_image_input(encInfo->src_image_fname);
     if (encInfo->fptr_src_image == NULL)
     {
         perror("fopen");
@@ -41,7 +59,7 @@ Status open_files(EncodeInfo *encInfo)
         return e_failure;
     }
 
-    encInfo->fptr_secret = fopen(encInfo->secret_fname, "rb");
+    encInfo->fptr_secret = open_input_stream(encInfo->secret_fname);
     if (encInfo->fptr_secret == NULL)
     {
         perror("fopen");
@@ -49,7 +67,9 @@ Status open_files(EncodeInfo *encInfo)
         return e_failure;
     }
 
-    encInfo->fptr_stego_image = fopen(encInfo->stego_image_fname, "wb");
+    // A BMP stego image is exactly as large as its cover
+    encInfo->fptr_stego_image = open_image_output(encInfo->stego_image_fname,
+                                                  regular_file_size(encInfo->fptr_src_image), encInfo->output_flags);
     if (encInfo->fptr_stego_image == NULL)
     {
         perror("fopen");
@@ -64,12 +84,26 @@ Status open_files(EncodeInfo *encInfo)
 /* ---------------------------------------------------------------
  * 📏 Get size of any file
  * --------------------------------------------------------------- */
-uint get_file_size(FILE *fptr)
+off_t get_file_size(FILE *fptr)
 {
-    fseek(fptr, 0, SEEK_END);
-    long size = ftell(fptr);
-    rewind(fptr);
-    printf("📄 Secret file size: %ld bytes\n", size);
+    struct stat st;
+    off_t size;
+
+    if (fstat(fileno(fptr), &st) == 0 && S_ISREG(st.st_mode))
+    {
+        // Regular file: size is known up front, counted from the current offset
+        size = st.st_size - ftello(fptr);
+    }
+    else
+    {
+        // Pipe or socket: the sender puts a 4 byte big-endian length first
+        unsigned char prefix[4];
+        if (fread(prefix, 1, 4, fptr) != 4)
+            return -1;
+        size = ((off_t)prefix[0] << 24) | (prefix[1] << 16) | (prefix[2] << 8) | prefix[3];
+    }
+
+    printf("📄 Secret file size: %lld bytes\n", (long long)size);
     return size;
 }
 
@@ -78,31 +112,102 @@ uint get_file_size(FILE *fptr)
  * --------------------------------------------------------------- */
 Status check_capacity(EncodeInfo* encInfo)
 {
-    encInfo->image_capacity = get_image_size_for_bmp(encInfo->fptr_src_image);
-    encInfo->size_secret_file = get_file_size(encInfo->fptr_secret);
+    encInfo->image_capacity = get_image_size_for_bmp(encInfo->fptr_src_image, encInfo->bmp_header);
+    return check_secret_fits(encInfo);
+}
 
-    if (encInfo->image_capacity >= 54 + (2 + 4 + 4 + 4 + (encInfo->size_secret_file)) * 8)
+/* ---------------------------------------------------------------
+ * 🌄 Count the high variance bytes of a seekable cover up front
+ * --------------------------------------------------------------- */
+static Status check_adaptive_fits(EncodeInfo *encInfo)
+{
+    AdaptiveGeometry geo;
+    uint64_t needed = (uint64_t)encInfo->size_secret_file * 8, selectable;
+
+    if (adaptive_geometry(encInfo->bmp_header, adaptive_header_len(encInfo->extn_secret_file), &geo) != 0 ||
+        geo.first_row + 2 >= geo.height)
     {
-        printf("✅ Image has sufficient capacity to store secret data.\n");
+        printf("⚠️  ERROR: Image is too small for adaptive embedding!\n");
+        return e_failure;
+    }
+
+    // A piped cover cannot be read twice, its capacity is only known while embedding
+    if (encInfo->fptr_src_image == NULL ||
+        adaptive_capacity(encInfo->fptr_src_image, &geo, encInfo->threshold, needed, &selectable) != 0)
+    {
+        printf("ℹ️  High variance capacity of a streamed cover is checked while embedding.\n");
         return e_success;
     }
-    else
+
+    if (selectable < needed)
     {
-        printf("⚠️  ERROR: Image does not have enough capacity!\n");
+        printf("⚠️  ERROR: Only %llu high variance bytes at threshold %u, %llu needed, try a lower threshold!\n",
+               (unsigned long long)selectable, encInfo->threshold, (unsigned long long)needed);
         return e_failure;
     }
+
+    printf("✅ Image has enough high variance pixels to store secret data.\n");
+    return e_success;
 }
 
 /* ---------------------------------------------------------------
- * 🧾 Copy BMP Header (first 54 bytes)
+ * 🧮 Check the secret against an already known image capacity
  * --------------------------------------------------------------- */
-Status copy_bmp_header(FILE *fptr_src_image, FILE *fptr_dest_image)
+Status check_secret_fits(EncodeInfo *encInfo)
 {
-    char header[54];
-    if (fread(header, 1, 54, fptr_src_image) != 54)
+    encInfo->size_secret_file = get_file_size(encInfo->fptr_secret);
+
+    if (encInfo->size_secret_file < 0)
+    {
+        printf("⚠️  ERROR: Unable to get secret file size!\n");
+        return e_failure;
+    }
+
+    // The secret size is stored in 32 bits inside the image
+    if ((uint64_t)encInfo->size_secret_file > UINT32_MAX)
+    {
+        printf("⚠️  ERROR: Secret file is larger than 4 GB!\n");
+        return e_failure;
+    }
+
+    // Bounded by the check above, so this cannot overflow 64 bits
+    uint64_t needed = 54 + (2 + 4 + 4 + 4 + (uint64_t)encInfo->size_secret_file) * 8;
+
+    if (encInfo->fec_nsym && (encInfo->fec_nsym < 2 || encInfo->fec_nsym > RS_MAX_NSYM))
+    {
+        printf("⚠️  ERROR: Invalid error correction level %d!\n", encInfo->fec_nsym);
         return e_failure;
+    }
 
-    if (fwrite(header, 1, 54, fptr_dest_image) != 54)
+    if (encInfo->fec_nsym)
+    {
+        // Magic, nsym copies, header codeword, then nsym parity bytes per block
+        uint64_t k = RS_BLOCK_SIZE - encInfo->fec_nsym;
+        uint64_t blocks = (encInfo->size_secret_file + k - 1) / k;
+        needed = 54 + (strlen(MAGIC_STRING_FEC) + FEC_PARAM_COPIES + FEC_HEADER_SIZE + encInfo->fec_nsym +
+                       (uint64_t)encInfo->size_secret_file + blocks * encInfo->fec_nsym) * 8;
+    }
+
+    if (encInfo->image_capacity < needed)
+    {
+        printf("⚠️  ERROR: Image does not have enough capacity!\n");
+        return e_failure;
+    }
+
+    // Adaptive data only goes into high variance bytes, the plain size says little
+    if (encInfo->adaptive)
+        return check_adaptive_fits(encInfo);
+
+    printf("✅ Image has sufficient capacity to store secret data.\n");
+    return e_success;
+}
+
+/* ---------------------------------------------------------------
+ * 🧾 Copy BMP Header (first 54 bytes)
+ * --------------------------------------------------------------- */
+Status copy_bmp_header(const char *header, FILE *fptr_dest_image)
+{
+    if (fwrite(header, 1, BMP_HEADER_SIZE, fptr_dest_image) != BMP_HEADER_SIZE)
         return e_failure;
 
     printf("📑 BMP header copied successfully!\n");
@@ -114,7 +219,7 @@ Status copy_bmp_header(FILE *fptr_src_image, FILE *fptr_dest_image)
  * --------------------------------------------------------------- */
 Status encode_magic_string(const char *magic_string, EncodeInfo *encInfo)
 {
-    if (encode_data_to_image(MAGIC_STRING, strlen(MAGIC_STRING), encInfo->fptr_src_image, encInfo->fptr_stego_image) == e_success)
+    if (encode_data_to_image(magic_string, strlen(magic_string), encInfo->fptr_src_image, encInfo->fptr_stego_image) == e_success)
     {
         printf("🔮 Magic string encoded successfully!\n");
         return e_success;
@@ -189,7 +294,7 @@ Status encode_secret_file_extn(const char *file_extn, EncodeInfo *encInfo)
 /* ---------------------------------------------------------------
  * 🧮 Encode Secret File Size
  * --------------------------------------------------------------- */ 
-Status encode_secret_file_size(long file_size, EncodeInfo *encInfo)
+Status encode_secret_file_size(off_t file_size, EncodeInfo *encInfo)
 {
     char image_buffer[32];
     if (fread(image_buffer, 1, 32, encInfo->fptr_src_image) != 32) return e_failure;
@@ -204,37 +309,297 @@ Status encode_secret_file_size(long file_size, EncodeInfo *encInfo)
  * --------------------------------------------------------------- */
 Status encode_secret_file_data(EncodeInfo *encInfo)
 {
-    char *buffer = malloc(encInfo->size_secret_file);
-    if (!buffer) return e_failure;
-
-    size_t bytes_read = fread(buffer, 1, encInfo->size_secret_file, encInfo->fptr_secret);
-    if (bytes_read != encInfo->size_secret_file)
+    // Stream the secret in chunks so large files are not held in memory
+    char *buffer = malloc(STREAM_CHUNK_SIZE);
+    char *image_bytes = malloc(STREAM_CHUNK_SIZE * 8);
+    if (!buffer || !image_bytes)
     {
         free(buffer);
+        free(image_bytes);
         return e_failure;
     }
 
-    for (int i = 0; i < encInfo->size_secret_file; i++)
+    off_t remaining = encInfo->size_secret_file;
+    while (remaining > 0)
     {
-        char image_bytes[8];
-        fread(image_bytes, 1, 8, encInfo->fptr_src_image);
-        encode_byte_to_lsb(buffer[i], image_bytes);
-        fwrite(image_bytes, 1, 8, encInfo->fptr_stego_image);
+        size_t chunk = remaining < STREAM_CHUNK_SIZE ? (size_t)remaining : STREAM_CHUNK_SIZE;
+
+        if (fread(buffer, 1, chunk, encInfo->fptr_secret) != chunk ||
+            fread(image_bytes, 1, chunk * 8, encInfo->fptr_src_image) != chunk * 8)
+        {
+            free(buffer);
+            free(image_bytes);
+            return e_failure;
+        }
+
+        for (size_t i = 0; i < chunk; i++)
+            encode_byte_to_lsb(buffer[i], image_bytes + i * 8);
+
+        if (fwrite(image_bytes, 1, chunk * 8, encInfo->fptr_stego_image) != chunk * 8)
+        {
+            free(buffer);
+            free(image_bytes);
+            return e_failure;
+        }
+        remaining -= chunk;
     }
 
     free(buffer);
+    free(image_bytes);
     printf("🗝️  Encoded secret file data successfully!\n");
     return e_success;
 }
 
+/* ---------------------------------------------------------------
+ * 🎚️ Encode adaptive threshold (one byte after the magic string)
+ * --------------------------------------------------------------- */
+Status encode_adaptive_threshold(EncodeInfo *encInfo)
+{
+    char threshold = encInfo->threshold;
+    if (encode_data_to_image(&threshold, 1, encInfo->fptr_src_image, encInfo->fptr_stego_image) != e_success)
+        return e_failure;
+
+    printf("🎚️  Encoded adaptive threshold %u successfully!\n", encInfo->threshold);
+    return e_success;
+}
+
+/* ---------------------------------------------------------------
+ * 🛡️ Encode FEC parity count, repeated so the decoder can vote
+ * --------------------------------------------------------------- */
+Status encode_fec_params(EncodeInfo *encInfo)
+{
+    char params[FEC_PARAM_COPIES];
+    memset(params, encInfo->fec_nsym, sizeof(params));
+
+    if (encode_data_to_image(params, FEC_PARAM_COPIES, encInfo->fptr_src_image, encInfo->fptr_stego_image) != e_success)
+        return e_failure;
+
+    printf("🛡️  Encoded error correction level (%d parity bytes per block) successfully!\n", encInfo->fec_nsym);
+    return e_success;
+}
+
+/* ---------------------------------------------------------------
+ * 🛡️ Encode extension and size as one protected codeword
+ * --------------------------------------------------------------- */
+Status encode_fec_header(EncodeInfo *encInfo)
+{
+    RsCode *code = malloc(sizeof(RsCode));
+    uint8_t block[RS_BLOCK_SIZE] = { 0 };
+    size_t extn_len = strlen(encInfo->extn_secret_file);
+    uint32_t size = encInfo->size_secret_file;
+
+    if (!code || extn_len >= MAX_FILE_SUFFIX)
+    {
+        free(code);
+        return e_failure;
+    }
+
+    // extn length, extn zero padded to 4 bytes, size big-endian
+    block[0] = extn_len;
+    memcpy(block + 1, encInfo->extn_secret_file, extn_len);
+    block[5] = size >> 24;
+    block[6] = size >> 16;
+    block[7] = size >> 8;
+    block[8] = size;
+
+    if (rs_init(code, encInfo->fec_nsym) != 0)
+    {
+        free(code);
+        return e_failure;
+    }
+    rs_encode(code, block, FEC_HEADER_SIZE, block + FEC_HEADER_SIZE);
+    free(code);
+
+    if (encode_data_to_image((char *)block, FEC_HEADER_SIZE + encInfo->fec_nsym,
+                             encInfo->fptr_src_image, encInfo->fptr_stego_image) != e_success)
+        return e_failure;
+
+    printf("🛡️  Encoded protected extension and size successfully!\n");
+    return e_success;
+}
+
+/* ---------------------------------------------------------------
+ * 🛡️ Encode Secret File Data in Reed-Solomon blocks
+ * --------------------------------------------------------------- */
+Status encode_secret_file_data_fec(EncodeInfo *encInfo)
+{
+    // Blocks are grouped so image bytes move in large reads and writes
+    const size_t group = STREAM_CHUNK_SIZE / RS_BLOCK_SIZE;
+    RsCode *code = malloc(sizeof(RsCode));
+    uint8_t *coded = malloc(group * RS_BLOCK_SIZE);
+    char *image_bytes = malloc(group * RS_BLOCK_SIZE * 8);
+    size_t k = RS_BLOCK_SIZE - encInfo->fec_nsym;
+    Status ret = e_failure;
+
+    if (!code || !coded || !image_bytes || rs_init(code, encInfo->fec_nsym) != 0)
+        goto out;
+
+    off_t remaining = encInfo->size_secret_file;
+    while (remaining > 0)
+    {
+        size_t coded_len = 0, full = 0;
+        for (size_t b = 0; b < group && remaining > 0; b++)
+        {
+            // Last block is shortened instead of padded
+            size_t chunk = remaining < (off_t)k ? (size_t)remaining : k;
+
+            if (fread(coded + coded_len, 1, chunk, encInfo->fptr_secret) != chunk)
+                goto out;
+            if (chunk < k)
+                rs_encode(code, coded + coded_len, chunk, coded + coded_len + chunk);
+            else
+                full++;
+            coded_len += chunk + encInfo->fec_nsym;
+            remaining -= chunk;
+        }
+        // Whole blocks sit back to back at the start, their parity is done side by side
+        rs_encode_blocks(code, coded, full);
+
+        if (fread(image_bytes, 1, coded_len * 8, encInfo->fptr_src_image) != coded_len * 8)
+            goto out;
+        for (size_t i = 0; i < coded_len; i++)
+            encode_byte_to_lsb(coded[i], image_bytes + i * 8);
+        if (fwrite(image_bytes, 1, coded_len * 8, encInfo->fptr_stego_image) != coded_len * 8)
+            goto out;
+    }
+    ret = e_success;
+
+out:
+    free(code);
+    free(coded);
+    free(image_bytes);
+    if (ret != e_success)
+        return e_failure;
+    printf("🛡️  Encoded protected secret file data successfully!\n");
+    return e_success;
+}
+
+/* ---------------------------------------------------------------
+ * 🔁 Copy n image bytes unchanged
+ * --------------------------------------------------------------- */
+static Status copy_image_bytes(FILE *fptr_src, FILE *fptr_dest, uint64_t n)
+{
+    char buffer[STREAM_CHUNK_SIZE];
+    while (n > 0)
+    {
+        size_t chunk = n < sizeof(buffer) ? n : sizeof(buffer);
+        if (fread(buffer, 1, chunk, fptr_src) != chunk || fwrite(buffer, 1, chunk, fptr_dest) != chunk)
+            return e_failure;
+        n -= chunk;
+    }
+    return e_success;
+}
+
+/* ---------------------------------------------------------------
+ * 🌄 Encode Secret File Data into busy (high variance) bytes only
+ * --------------------------------------------------------------- */
+Status encode_secret_file_data_adaptive(EncodeInfo *encInfo)
+{
+    AdaptiveGeometry geo;
+
+    // Bytes already used by the sequential header fields
+    uint64_t header_len = adaptive_header_len(encInfo->extn_secret_file);
+
+    if (adaptive_geometry(encInfo->bmp_header, header_len, &geo) != 0 || geo.first_row + 2 >= geo.height)
+        return e_failure;
+
+    // Align to the first whole row, which only serves as the row above
+    if (copy_image_bytes(encInfo->fptr_src_image, encInfo->fptr_stego_image, geo.first_row * geo.stride - header_len) != e_success)
+        return e_failure;
+
+    unsigned char *rows = malloc(geo.stride * 3 + geo.row_bytes);
+    char *secret = malloc(STREAM_CHUNK_SIZE);
+    if (!rows || !secret)
+    {
+        free(rows);
+        free(secret);
+        return e_failure;
+    }
+    unsigned char *prev = rows, *cur = rows + geo.stride, *next = rows + 2 * geo.stride;
+    unsigned char *sel = rows + 3 * geo.stride;
+
+    off_t remaining = encInfo->size_secret_file;
+    size_t secret_len = 0, secret_pos = 0;
+    int bit = 0;
+    Status ret = e_failure;
+
+    // Three row window: rows y-1 and y+1 decide which bytes of row y carry bits
+    if (fread(prev, 1, geo.stride, encInfo->fptr_src_image) != geo.stride ||
+        fread(cur, 1, geo.stride, encInfo->fptr_src_image) != geo.stride)
+        goto out;
+
+    for (uint64_t y = geo.first_row + 1; y + 1 < geo.height && (remaining > 0 || secret_pos < secret_len); y++)
+    {
+        if (fread(next, 1, geo.stride, encInfo->fptr_src_image) != geo.stride)
+            goto out;
+
+        adaptive_select_row(prev, cur, next, geo.row_bytes, encInfo->threshold, sel);
+
+        for (size_t x = 0; x < geo.row_bytes; x++)
+        {
+            if (!sel[x])
+                continue;
+
+            if (secret_pos == secret_len)
+            {
+                if (remaining == 0)
+                    break;
+                secret_len = remaining < STREAM_CHUNK_SIZE ? (size_t)remaining : STREAM_CHUNK_SIZE;
+                if (fread(secret, 1, secret_len, encInfo->fptr_secret) != secret_len)
+                    goto out;
+                remaining -= secret_len;
+                secret_pos = 0;
+            }
+
+            cur[x] = (cur[x] & ~1) | ((secret[secret_pos] >> (7 - bit)) & 1);
+            if (++bit == 8)
+            {
+                bit = 0;
+                secret_pos++;
+            }
+        }
+
+        if (fwrite(prev, 1, geo.stride, encInfo->fptr_stego_image) != geo.stride)
+            goto out;
+        unsigned char *tmp = prev;
+        prev = cur;
+        cur = next;
+        next = tmp;
+    }
+
+    if (fwrite(prev, 1, geo.stride, encInfo->fptr_stego_image) != geo.stride ||
+        fwrite(cur, 1, geo.stride, encInfo->fptr_stego_image) != geo.stride)
+        goto out;
+
+    if (remaining > 0 || secret_pos < secret_len)
+    {
+        printf("⚠️  ERROR: Not enough high variance pixels, try a lower threshold!\n");
+        goto out;
+    }
+
+    printf("🌄 Encoded secret file data into high variance pixels successfully!\n");
+    ret = e_success;
+
+out:
+    free(rows);
+    free(secret);
+    return ret;
+}
+
 /* ---------------------------------------------------------------
  * 🖋️ Copy remaining data from source to output image
  * --------------------------------------------------------------- */
 Status copy_remaining_img_data(FILE *fptr_src, FILE *fptr_dest)
 {
-    char ch;
-    while (fread(&ch, 1, 1, fptr_src) == 1)
-        fwrite(&ch, 1, 1, fptr_dest);
+    char buffer[STREAM_CHUNK_SIZE];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), fptr_src)) > 0)
+    {
+        if (fwrite(buffer, 1, n, fptr_dest) != n)
+            return e_failure;
+    }
+    if (ferror(fptr_src))
+        return e_failure;
 
     printf("🖋️  Remaining image data copied successfully!\n");
     return e_success;
@@ -245,18 +610,67 @@ Status copy_remaining_img_data(FILE *fptr_src, FILE *fptr_dest)
  * --------------------------------------------------------------- */
 Status do_encoding(EncodeInfo *encInfo)
 {
+    IoStats stats;
+
     printf("\n🚀 Starting Encoding Process...\n");
+    io_stats_start(&stats);
 
     if (open_files(encInfo) != e_success) return e_failure;
+    Status ret = do_encoding_opened(encInfo);
+
+    // A PNG output is compressed and written when it is closed
+    fclose(encInfo->fptr_src_image);
+    fclose(encInfo->fptr_secret);
+    if (fclose(encInfo->fptr_stego_image) != 0)
+        ret = e_failure;
+
+    // A half written stego image would not decode, do not leave it behind
+    if (ret != e_success && !is_stream_name(encInfo->stego_image_fname))
+        remove(encInfo->stego_image_fname);
+
+    if (ret == e_success && (encInfo->output_flags & OUTPUT_STATS))
+    {
+        io_stats_add_output(&stats, encInfo->stego_image_fname);
+        io_stats_print(&stats);
+    }
+    return ret;
+}
+
+/* ---------------------------------------------------------------
+ * 🧵 Encoding on files that are already open (used by the server)
+ * --------------------------------------------------------------- */
+Status do_encoding_opened(EncodeInfo *encInfo)
+{
     if (check_capacity(encInfo) != e_success) return e_failure;
-    if (copy_bmp_header(encInfo->fptr_src_image, encInfo->fptr_stego_image) != e_success) return e_failure;
-    if (encode_magic_string(MAGIC_STRING, encInfo) != e_success) return e_failure;
-    if (encode_secret_file_extn_size(encInfo->extn_secret_file, encInfo) != e_success) return e_failure;
-    if (encode_secret_file_extn(encInfo->extn_secret_file, encInfo) != e_success) return e_failure;
-    if (encode_secret_file_size(encInfo->size_secret_file, encInfo) != e_success) return e_failure;
-    if (encode_secret_file_data(encInfo) != e_success) return e_failure;
+    if (encode_secret_fields(encInfo) != e_success) return e_failure;
     if (copy_remaining_img_data(encInfo->fptr_src_image, encInfo->fptr_stego_image) != e_success) return e_failure;
 
     printf("\n✅ Encoding completed successfully! Secret data embedded into image.\n");
     return e_success;
 }
+
+/* ---------------------------------------------------------------
+ * 🧩 Header, magic string and every secret field, in image order
+ * --------------------------------------------------------------- */
+Status encode_secret_fields(EncodeInfo *encInfo)
+{
+    if (copy_bmp_header(encInfo->bmp_header, encInfo->fptr_stego_image) != e_success) return e_failure;
+
+    if (encInfo->fec_nsym)
+    {
+        // Protected layout: everything after the magic string is Reed-Solomon coded
+        if (encode_magic_string(MAGIC_STRING_FEC, encInfo) != e_success) return e_failure;
+        if (encode_fec_params(encInfo) != e_success) return e_failure;
+        if (encode_fec_header(encInfo) != e_success) return e_failure;
+        return encode_secret_file_data_fec(encInfo);
+    }
+
+    if (encode_magic_string(encInfo->adaptive ? MAGIC_STRING_ADAPTIVE : MAGIC_STRING, encInfo) != e_success) return e_failure;
+    if (encInfo->adaptive && encode_adaptive_threshold(encInfo) != e_success) return e_failure;
+    if (encode_secret_file_extn_size(encInfo->extn_secret_file, encInfo) != e_success) return e_failure;
+    if (encode_secret_file_extn(encInfo->extn_secret_file, encInfo) != e_success) return e_failure;
+    if (encode_secret_file_size(encInfo->size_secret_file, encInfo) != e_success) return e_failure;
+    if (encInfo->adaptive)
+        return encode_secret_file_data_adaptive(encInfo);
+    return encode_secret_file_data(encInfo);
+}
@@ -16,26 +16,33 @@
 #define MAX_SECRET_BUF_SIZE 1
 #define MAX_IMAGE_BUF_SIZE (MAX_SECRET_BUF_SIZE * 8)
 #define MAX_FILE_SUFFIX 5
+#define STREAM_CHUNK_SIZE (64 * 1024) // secret bytes handled per read when streaming
+#define BMP_HEADER_SIZE 54
 
 typedef struct EncodeInfo
 {
     /* Source Image info */
     char *src_image_fname;//To store the beautiful.bmp
     FILE *fptr_src_image;//to hold the beautiful.bmp offset
-    uint image_capacity;//to store the size
+    uint64_t image_capacity;//to store the size
     uint bits_per_pixel;
     char image_data[MAX_IMAGE_BUF_SIZE];//to store the readed 8 bytes
+    char bmp_header[BMP_HEADER_SIZE];//header read once, so the cover is never seeked
 
     /* Secret File Info */
     char *secret_fname;//to store secret.txt name
     FILE *fptr_secret;//to hold address of secret.txt
     char extn_secret_file[MAX_FILE_SUFFIX];//to store extension of secret file
+    int adaptive;//1 to embed only into high variance bytes
+    unsigned char threshold;//minimum neighbour difference for adaptive mode
+    int fec_nsym;//Reed-Solomon parity bytes per block, 0 for none
     char secret_data[MAX_SECRET_BUF_SIZE];//to store secret data of 1byte
-    long size_secret_file;//to store secret file size
+    off_t size_secret_file;//to store secret file size
 
     /* Stego Image Info */
     char *stego_image_fname;//to store o/p file name
     FILE *fptr_stego_image;//to store o/p file offset(address)
+    int output_flags;//OUTPUT_* bits: page cache handling and stats
 
 } EncodeInfo;
 
@@ -51,20 +58,29 @@ Status read_and_validate_encode_args(int argc,char *argv[], EncodeInfo *encInfo)
 /* Perform the encoding */
 Status do_encoding(EncodeInfo *encInfo);
 
+/* Perform the encoding on already opened files */
+Status do_encoding_opened(EncodeInfo *encInfo);
+
 /* Get File pointers for i/p and o/p files */
 Status open_files(EncodeInfo *encInfo);
 
 /* check capacity */
 Status check_capacity(EncodeInfo *encInfo);
 
-/* Get image size */
-uint get_image_size_for_bmp(FILE *fptr_image);
+/* Check the secret size against encInfo->image_capacity */
+Status check_secret_fits(EncodeInfo *encInfo);
+
+/* Write the header and encode every secret field, leaving the rest of the image */
+Status encode_secret_fields(EncodeInfo *encInfo);
 
-/* Get file size */
-uint get_file_size(FILE *fptr);
+/* Read bmp header and get image size */
+uint64_t get_image_size_for_bmp(FILE *fptr_image, char *header);
 
-/* Copy bmp image header */
-Status copy_bmp_header(FILE *fptr_src_image, FILE *fptr_dest_image);
+/* Get file size (or read its length prefix when it is a pipe) */
+off_t get_file_size(FILE *fptr);
+
+/* Write the bmp image header read by get_image_size_for_bmp */
+Status copy_bmp_header(const char *header, FILE *fptr_dest_image);
 
 /* Store Magic String */
 Status encode_magic_string(const char *magic_string, EncodeInfo *encInfo);
@@ -73,11 +89,26 @@ Status encode_magic_string(const char *magic_string, EncodeInfo *encInfo);
 Status encode_secret_file_extn(const char *file_extn, EncodeInfo *encInfo);
 
 /* Encode secret file size */
-Status encode_secret_file_size(long file_size, EncodeInfo *encInfo);
+Status encode_secret_file_size(off_t file_size, EncodeInfo *encInfo);
 
 /* Encode secret file data*/
 Status encode_secret_file_data(EncodeInfo *encInfo);
 
+/* Encode the adaptive threshold byte */
+Status encode_adaptive_threshold(EncodeInfo *encInfo);
+
+/* Encode secret file data into high variance bytes only */
+Status encode_secret_file_data_adaptive(EncodeInfo *encInfo);
+
+/* Encode the Reed-Solomon parity count (repeated for majority voting) */
+Status encode_fec_params(EncodeInfo *encInfo);
+
+/* Encode extension and size as one Reed-Solomon codeword */
+Status encode_fec_header(EncodeInfo *encInfo);
+
+/* Encode secret file data as Reed-Solomon codewords */
+Status encode_secret_file_data_fec(EncodeInfo *encInfo);
+
 /* Encode function, which does the real encoding */
 Status encode_data_to_image(const char *data, int size, FILE *fptr_src_image, FILE *fptr_stego_image);
 
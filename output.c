@@ -0,0 +1,300 @@
+/* Name : Shobharaj H L
+   Date : 12/11/2025
+   Description : LSB_IMAGE_STEGANOGRAPHY */
+#define _GNU_SOURCE
+#define _FILE_OFFSET_BITS 64
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include "output.h"
+
+typedef struct BulkOutput
+{
+    int fd;
+    int flags;//OUTPUT_* bits in effect
+    int regular;//1 for a regular file
+    off_t expected;//size reserved with fallocate, 0 if none
+    off_t pos;//bytes handed to the kernel
+    off_t started;//writeback started up to here
+    off_t dropped;//written back and dropped up to here
+    unsigned char *buf;//O_DIRECT staging buffer, OUTPUT_ALIGN aligned
+    size_t fill;
+} BulkOutput;
+
+ // Function: write_all
+ // Purpose : write(2) until everything is out
+static int write_all(int fd, const unsigned char *buf, size_t n)
+{
+    while (n > 0)
+    {
+        ssize_t done = write(fd, buf, n);
+        if (done < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        buf += done;
+        n -= done;
+    }
+    return 0;
+}
+
+ // Function: write_behind
+ // Purpose : Start writeback of the new data, wait for the window before it and drop it
+static void write_behind(BulkOutput *out)
+{
+    sync_file_range(out->fd, out->started, out->pos - out->started, SYNC_FILE_RANGE_WRITE);
+
+    if (out->started > out->dropped)
+    {
+        sync_file_range(out->fd, out->dropped, out->started - out->dropped,
+                        SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+        posix_fadvise(out->fd, out->dropped, out->started - out->dropped, POSIX_FADV_DONTNEED);
+        out->dropped = out->started;
+    }
+    out->started = out->pos;
+}
+
+static ssize_t bulk_write(void *cookie, const char *buf, size_t n)
+{
+    BulkOutput *out = cookie;
+
+    if (!(out->flags & OUTPUT_DIRECT))
+    {
+        if (write_all(out->fd, (const unsigned char *)buf, n) != 0)
+            return 0;
+        out->pos += n;
+        if ((out->flags & OUTPUT_DROP_CACHE) && out->pos - out->started >= OUTPUT_WRITE_BEHIND)
+            write_behind(out);
+        return n;
+    }
+
+    // O_DIRECT: only whole aligned buffers go to the kernel
+    for (size_t left = n; left > 0;)
+    {
+        size_t take = OUTPUT_BUF_SIZE - out->fill < left ? OUTPUT_BUF_SIZE - out->fill : left;
+        memcpy(out->buf + out->fill, buf, take);
+        out->fill += take;
+        buf += take;
+        left -= take;
+
+        if (out->fill == OUTPUT_BUF_SIZE)
+        {
+            if (write_all(out->fd, out->buf, OUTPUT_BUF_SIZE) != 0)
+                return 0;
+            out->pos += OUTPUT_BUF_SIZE;
+            out->fill = 0;
+        }
+    }
+    return n;
+}
+
+static int bulk_seek(void *cookie, off64_t *offset, int whence)
+{
+    BulkOutput *out = cookie;
+
+    // Output is written strictly in order, only the position can be asked for
+    if (whence != SEEK_CUR || *offset != 0)
+        return -1;
+    *offset = out->pos + out->fill;
+    return 0;
+}
+
+static int bulk_close(void *cookie)
+{
+    BulkOutput *out = cookie;
+    off_t size = out->pos + out->fill;
+    int ret = 0;
+
+    if (out->fill > 0)
+    {
+        // The O_DIRECT tail goes out as whole blocks, the file is cut back below
+        size_t padded = (out->fill + OUTPUT_ALIGN - 1) & ~(size_t)(OUTPUT_ALIGN - 1);
+        memset(out->buf + out->fill, 0, padded - out->fill);
+        if (write_all(out->fd, out->buf, padded) != 0)
+            ret = -1;
+    }
+
+    // Give back what the padding or an unused reservation added
+    if (out->regular && (out->fill > 0 || out->expected > size) && ftruncate(out->fd, size) != 0)
+        ret = -1;
+
+    // Nothing written by a bulk run is read back: flush it and drop it from the cache
+    if (out->regular && (out->flags & (OUTPUT_DROP_CACHE | OUTPUT_DIRECT)))
+    {
+        if (fdatasync(out->fd) != 0)
+            ret = -1;
+        posix_fadvise(out->fd, 0, 0, POSIX_FADV_DONTNEED);
+    }
+
+    if (close(out->fd) != 0)
+        ret = -1;
+    free(out->buf);
+    free(out);
+    return ret;
+}
+
+ // Function: regular_file_size
+ // Purpose : Size to reserve for an output copied from this input
+off_t regular_file_size(FILE *fptr)
+{
+    struct stat st;
+    int fd = fileno(fptr);
+
+    if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+        return 0;
+    return st.st_size;
+}
+
+ // Function: bulk_output_fd
+ // Purpose : Reserve the final size and set up cache friendly writes on fd
+FILE *bulk_output_fd(int fd, off_t expected_size, int flags)
+{
+    cookie_io_functions_t io = {NULL, bulk_write, bulk_seek, bulk_close};
+    BulkOutput *out = calloc(1, sizeof(*out));
+    struct stat st;
+
+    if (out == NULL)
+    {
+        close(fd);
+        return NULL;
+    }
+    out->fd = fd;
+    out->flags = flags & (OUTPUT_DROP_CACHE | OUTPUT_DIRECT);
+    out->regular = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+
+    if (out->flags & OUTPUT_DIRECT)
+    {
+        void *buf = NULL;
+        int fl = fcntl(fd, F_GETFL);
+
+        // Not every file system takes O_DIRECT: fall back to dropping pages after writing
+        if (!out->regular || posix_memalign(&buf, OUTPUT_ALIGN, OUTPUT_BUF_SIZE) != 0 ||
+            fl < 0 || fcntl(fd, F_SETFL, fl | O_DIRECT) != 0)
+        {
+            printf("⚠️  O_DIRECT is not available for this output, dropping written pages instead\n");
+            free(buf);
+            out->flags = OUTPUT_DROP_CACHE;
+        }
+        else
+            out->buf = buf;
+    }
+
+    // Reserve the whole image in one go, so the file is not fragmented. Plain
+    // fallocate: where it is unsupported we skip it rather than write zeros
+    if (out->regular && expected_size > 0 && fallocate(fd, 0, 0, expected_size) == 0)
+        out->expected = expected_size;
+
+    FILE *fptr = fopencookie(out, "wb", io);
+    if (fptr == NULL)
+    {
+        close(fd);
+        free(out->buf);
+        free(out);
+        return NULL;
+    }
+    setvbuf(fptr, NULL, _IOFBF, OUTPUT_BUF_SIZE);
+    return fptr;
+}
+
+ // Function: open_bulk_output
+ // Purpose : Create the output file and wrap it
+FILE *open_bulk_output(const char *fname, off_t expected_size, int flags)
+{
+    int fd = open(fname, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+    if (fd < 0)
+        return NULL;
+    return bulk_output_fd(fd, expected_size, flags);
+}
+
+/* ---------------------------------------------------------------
+ * 📊 Run statistics
+ * --------------------------------------------------------------- */
+
+ // Function: io_stats_start
+ // Purpose : Remember when the run started
+void io_stats_start(IoStats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    clock_gettime(CLOCK_MONOTONIC, &stats->start);
+}
+
+ // Function: io_stats_add_output
+ // Purpose : Size of a finished output and its pages still in the page cache
+void io_stats_add_output(IoStats *stats, const char *fname)
+{
+    struct stat st;
+    int fd = open(fname, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+        return;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        close(fd);
+        return;
+    }
+
+    stats->files++;
+    stats->bytes_written += st.st_size;
+
+    // Mapping does not fault anything in, so mincore sees the cache as it is
+    long page = sysconf(_SC_PAGESIZE);
+    size_t pages = (st.st_size + page - 1) / page;
+    void *map = st.st_size > 0 ? mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    unsigned char *vec = map != MAP_FAILED ? malloc(pages) : NULL;
+
+    if (vec != NULL && mincore(map, st.st_size, vec) == 0)
+    {
+        uint64_t resident = 0;
+        for (size_t i = 0; i < pages; i++)
+            resident += vec[i] & 1;
+        resident *= page;
+        stats->cached_bytes += resident < (uint64_t)st.st_size ? resident : (uint64_t)st.st_size;
+    }
+
+    free(vec);
+    if (map != MAP_FAILED)
+        munmap(map, st.st_size);
+    close(fd);
+}
+
+ // Function: io_stats_print
+ // Purpose : Throughput, memory and page cache footprint of the run
+void io_stats_print(const IoStats *stats)
+{
+    struct timespec now;
+    struct rusage ru;
+    long rss_pages = 0;
+    double mb = 1024.0 * 1024.0;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double secs = (now.tv_sec - stats->start.tv_sec) + (now.tv_nsec - stats->start.tv_nsec) / 1e9;
+
+    getrusage(RUSAGE_SELF, &ru);
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm != NULL)
+    {
+        if (fscanf(statm, "%*d %ld", &rss_pages) != 1)
+            rss_pages = 0;
+        fclose(statm);
+    }
+
+    printf("\n📊 I/O statistics\n");
+    printf("------------------------------------------\n");
+    printf("📦 Written    : %d file(s), %.1f MB in %.3f s (%.1f MB/s)\n", stats->files,
+           stats->bytes_written / mb, secs, secs > 0 ? stats->bytes_written / mb / secs : 0.0);
+    printf("🧠 RSS        : %.1f MB now, %.1f MB peak\n",
+           rss_pages * (double)sysconf(_SC_PAGESIZE) / mb, ru.ru_maxrss / 1024.0);
+    printf("🗃️  Page cache : %.1f MB of the output still cached (%.0f%%)\n", stats->cached_bytes / mb,
+           stats->bytes_written ? 100.0 * stats->cached_bytes / stats->bytes_written : 0.0);
+    printf("------------------------------------------\n");
+}
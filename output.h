@@ -0,0 +1,58 @@
+/* Name : Shobharaj H L
+   Date : 12/11/2025
+   Description : LSB_IMAGE_STEGANOGRAPHY */
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/types.h>
+
+/*
+ * Stego image writer for bulk runs. The final size is reserved up
+ * front so the file is laid out in one piece, writes go out in large
+ * blocks, and on request the written pages are pushed to disk and
+ * dropped as we go (or never cached at all with O_DIRECT), so long
+ * runs do not evict the covers and other hot data from the page cache.
+ */
+
+#define OUTPUT_BUF_SIZE (1024 * 1024) // stdio buffer, and O_DIRECT staging buffer
+#define OUTPUT_ALIGN 4096 // O_DIRECT buffer, offset and length alignment
+#define OUTPUT_WRITE_BEHIND (8 * 1024 * 1024) // bytes written before writeback is started
+
+/* Output flags */
+#define OUTPUT_DROP_CACHE 1 // write behind and drop written pages from the page cache
+#define OUTPUT_DIRECT 2 // bypass the page cache with O_DIRECT
+#define OUTPUT_STATS 4 // report throughput, RSS and page cache use
+
+typedef struct IoStats
+{
+    struct timespec start;
+    int files;//outputs counted
+    uint64_t bytes_written;
+    uint64_t cached_bytes;//output bytes still in the page cache
+} IoStats;
+
+
+/* Output function prototype */
+
+/* Size of a regular file, 0 for pipes and other streams */
+off_t regular_file_size(FILE *fptr);
+
+/* Wrap an output descriptor (closed on fclose), expected_size 0 if unknown */
+FILE *bulk_output_fd(int fd, off_t expected_size, int flags);
+
+/* Create fname and open it like bulk_output_fd */
+FILE *open_bulk_output(const char *fname, off_t expected_size, int flags);
+
+/* Start measuring a run */
+void io_stats_start(IoStats *stats);
+
+/* Count a finished output: its size and how much of it is still cached */
+void io_stats_add_output(IoStats *stats, const char *fname);
+
+/* Print throughput, RSS and page cache use */
+void io_stats_print(const IoStats *stats);
+
+#endif
@@ -0,0 +1,859 @@
+/* Name : Shobharaj H L
+   Date : 12/11/2025
+   Description : LSB_IMAGE_STEGANOGRAPHY */
+#define _GNU_SOURCE
+#define _FILE_OFFSET_BITS 64
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <zlib.h>
+#include "png.h"
+#include "encode.h"
+#include "stream.h"
+#include "output.h"
+#include "typese.h"
+
+static const unsigned char png_signature[PNG_SIGNATURE_SIZE] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+/* zlib header for PNG_DEFLATE_LEVEL: 32K window, default compression */
+static const unsigned char zlib_header[2] = {0x78, 0x9c};
+
+static uint32_t get_be32(const unsigned char *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void put_be32(unsigned char *p, uint32_t value)
+{
+    p[0] = value >> 24;
+    p[1] = value >> 16;
+    p[2] = value >> 8;
+    p[3] = value;
+}
+
+static inline unsigned char paeth(unsigned char a, unsigned char b, unsigned char c)
+{
+    int p = a + b - c;
+    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+
+    if (pa <= pb && pa <= pc)
+        return a;
+    return pb <= pc ? b : c;
+}
+
+ // Function: is_png_name
+ // Purpose : PNG images are recognised by the .png suffix, not by a .png directory or a.png.bmp
+int is_png_name(const char *fname)
+{
+    size_t len = fname != NULL ? strlen(fname) : 0;
+
+    return len > strlen(PNG_EXTN) && strcmp(fname + len - strlen(PNG_EXTN), PNG_EXTN) == 0;
+}
+
+ // Function: bmp_row_stride
+ // Purpose : Rows are padded to 4 bytes unless biSizeImage covers exactly width * 3 * height
+size_t bmp_row_stride(const char *bmp_header)
+{
+    int32_t width, height;
+    uint32_t image_size;
+
+    memcpy(&width, bmp_header + 18, sizeof(width));
+    memcpy(&height, bmp_header + 22, sizeof(height));
+    memcpy(&image_size, bmp_header + 34, sizeof(image_size));
+    if (height < 0)
+        height = -height;
+    if (width <= 0)
+        return 0;
+
+    size_t row_bytes = (size_t)width * 3;
+    if ((uint64_t)image_size == (uint64_t)row_bytes * height)
+        return row_bytes;
+    return (row_bytes + 3) & ~(size_t)3;
+}
+
+/* ---------------------------------------------------------------
+ * 🔓 PNG decoding
+ * --------------------------------------------------------------- */
+
+ // Function: unfilter_row
+ // Purpose : Undo one PNG filter in place (3 bytes per pixel)
+static int unfilter_row(unsigned char filter, unsigned char *cur, const unsigned char *prev, size_t n)
+{
+    size_t i;
+
+    switch (filter)
+    {
+    case 0:
+        break;
+    case 1:
+        for (i = 3; i < n; i++)
+            cur[i] += cur[i - 3];
+        break;
+    case 2:
+        for (i = 0; i < n; i++)
+            cur[i] += prev[i];
+        break;
+    case 3:
+        for (i = 0; i < 3; i++)
+            cur[i] += prev[i] >> 1;
+        for (; i < n; i++)
+            cur[i] += (cur[i - 3] + prev[i]) >> 1;
+        break;
+    case 4:
+        for (i = 0; i < 3; i++)
+            cur[i] += prev[i];
+        for (; i < n; i++)
+            cur[i] += paeth(cur[i - 3], prev[i], prev[i - 3]);
+        break;
+    default:
+        return -1;
+    }
+    return 0;
+}
+
+ // Function: make_bmp_header
+ // Purpose : Header of the packed bottom-up BMP view of a PNG
+static void make_bmp_header(unsigned char *header, int32_t width, int32_t height, uint32_t image_size)
+{
+    uint32_t file_size = image_size ? BMP_HEADER_SIZE + image_size : 0;
+    uint32_t offset = BMP_HEADER_SIZE, info_size = 40, ppm = 2835;
+    uint16_t planes = 1, bpp = 24;
+
+    memset(header, 0, BMP_HEADER_SIZE);
+    header[0] = 'B';
+    header[1] = 'M';
+    memcpy(header + 2, &file_size, sizeof(file_size));
+    memcpy(header + 10, &offset, sizeof(offset));
+    memcpy(header + 14, &info_size, sizeof(info_size));
+    memcpy(header + 18, &width, sizeof(width));
+    memcpy(header + 22, &height, sizeof(height));
+    memcpy(header + 26, &planes, sizeof(planes));
+    memcpy(header + 28, &bpp, sizeof(bpp));
+    memcpy(header + 34, &image_size, sizeof(image_size));
+    memcpy(header + 38, &ppm, sizeof(ppm));
+    memcpy(header + 42, &ppm, sizeof(ppm));
+}
+
+ // Function: png_decode_to_bmp
+ // Purpose : Inflate scanline by scanline straight into the BMP view
+Status png_decode_to_bmp(FILE *fptr_png, unsigned char **bmp, size_t *bmp_size)
+{
+    unsigned char sig[PNG_SIGNATURE_SIZE], head[8], ihdr[13], crc_buf[4], extra;
+    unsigned char *in = malloc(PNG_IO_CHUNK), *rows = NULL, *out = NULL;
+    uint32_t width = 0, height = 0, row = 0;
+    size_t row_bytes = 0, image_size = 0;
+    int inflating = 0, ended = 0;
+    z_stream zs;
+    Status ret = e_failure;
+
+    memset(&zs, 0, sizeof(zs));
+    *bmp = NULL;
+    *bmp_size = 0;
+
+    if (in == NULL)
+        return e_failure;
+
+    if (fread(sig, 1, sizeof(sig), fptr_png) != sizeof(sig) || memcmp(sig, png_signature, sizeof(sig)) != 0)
+    {
+        printf("❌ ERROR: Not a PNG image!\n");
+        goto out;
+    }
+
+    for (;;)
+    {
+        if (fread(head, 1, sizeof(head), fptr_png) != sizeof(head))
+            goto truncated;
+
+        uint32_t len = get_be32(head);
+        const unsigned char *type = head + 4;
+        uLong crc = crc32(0L, type, 4);
+        if (len > 0x7fffffff)
+            goto truncated;
+
+        if (memcmp(type, "IHDR", 4) == 0)
+        {
+            if (inflating || len != sizeof(ihdr) || fread(ihdr, 1, sizeof(ihdr), fptr_png) != sizeof(ihdr))
+                goto truncated;
+            crc = crc32(crc, ihdr, sizeof(ihdr));
+
+            width = get_be32(ihdr);
+            height = get_be32(ihdr + 4);
+
+            // 8 bit truecolour without interlacing is exactly what a 24 bpp BMP holds
+            if (ihdr[8] != 8 || ihdr[9] != 2 || ihdr[10] != 0 || ihdr[11] != 0 || ihdr[12] != 0 ||
+                width == 0 || height == 0 || width > 0x7fffffff || height > 0x7fffffff)
+            {
+                printf("❌ ERROR: Only 8 bit RGB non-interlaced PNG images are supported!\n");
+                goto out;
+            }
+
+            row_bytes = (size_t)width * 3;
+            if (__builtin_mul_overflow(row_bytes, (size_t)height, &image_size) ||
+                __builtin_add_overflow(image_size, (size_t)BMP_HEADER_SIZE, bmp_size))
+                goto out;
+
+            // Packed rows are marked through biSizeImage, which has 32 bits only
+            if (image_size > UINT32_MAX && row_bytes % 4 != 0)
+            {
+                printf("❌ ERROR: PNG image too large for a BMP view!\n");
+                goto out;
+            }
+
+            out = malloc(*bmp_size);
+            rows = calloc(2, row_bytes + 1);
+            if (out == NULL || rows == NULL || inflateInit(&zs) != Z_OK)
+                goto out;
+            inflating = 1;
+
+            zs.next_out = rows;
+            zs.avail_out = row_bytes + 1;
+        }
+        else if (memcmp(type, "IDAT", 4) == 0)
+        {
+            if (!inflating)
+                goto truncated;
+
+            while (len > 0)
+            {
+                size_t n = len < PNG_IO_CHUNK ? len : PNG_IO_CHUNK;
+                if (fread(in, 1, n, fptr_png) != n)
+                    goto truncated;
+                crc = crc32(crc, in, n);
+                len -= n;
+
+                zs.next_in = in;
+                zs.avail_in = n;
+                while (zs.avail_in > 0 && !ended)
+                {
+                    int z = inflate(&zs, Z_NO_FLUSH);
+                    if (z == Z_STREAM_END)
+                        ended = 1;
+                    else if (z != Z_OK)
+                        goto truncated;
+
+                    if (zs.avail_out != 0)
+                        continue;
+
+                    // More scanline data than the image holds
+                    if (row == height)
+                        goto truncated;
+
+                    unsigned char *cur = rows + (size_t)(row & 1) * (row_bytes + 1);
+                    const unsigned char *prev = rows + (size_t)(~row & 1) * (row_bytes + 1) + 1;
+                    if (unfilter_row(cur[0], cur + 1, prev, row_bytes) != 0)
+                        goto truncated;
+
+                    // PNG rows run top-down in RGB, the BMP view bottom-up in BGR
+                    unsigned char *dst = out + BMP_HEADER_SIZE + (size_t)(height - 1 - row) * row_bytes;
+                    for (size_t x = 0; x < row_bytes; x += 3)
+                    {
+                        dst[x] = cur[1 + x + 2];
+                        dst[x + 1] = cur[1 + x + 1];
+                        dst[x + 2] = cur[1 + x];
+                    }
+
+                    row++;
+                    if (row < height)
+                    {
+                        zs.next_out = rows + (size_t)(row & 1) * (row_bytes + 1);
+                        zs.avail_out = row_bytes + 1;
+                    }
+                    else
+                    {
+                        // Let inflate check the trailer, any extra byte is an error
+                        zs.next_out = &extra;
+                        zs.avail_out = 1;
+                    }
+                }
+            }
+        }
+        else if (memcmp(type, "IEND", 4) == 0 || memcmp(type, "PLTE", 4) == 0 || (type[0] & 0x20))
+        {
+            // Ancillary chunks (and the optional palette) do not touch the pixels
+            while (len > 0)
+            {
+                size_t n = len < PNG_IO_CHUNK ? len : PNG_IO_CHUNK;
+                if (fread(in, 1, n, fptr_png) != n)
+                    goto truncated;
+                crc = crc32(crc, in, n);
+                len -= n;
+            }
+        }
+        else
+        {
+            printf("❌ ERROR: Unsupported PNG chunk %.4s!\n", (const char *)type);
+            goto out;
+        }
+
+        if (fread(crc_buf, 1, 4, fptr_png) != 4)
+            goto truncated;
+        if (get_be32(crc_buf) != (uint32_t)crc)
+        {
+            printf("❌ ERROR: PNG chunk %.4s is corrupted (CRC mismatch)!\n", (const char *)type);
+            goto out;
+        }
+
+        if (memcmp(type, "IEND", 4) == 0)
+            break;
+    }
+
+    if (!inflating || !ended || row != height)
+        goto truncated;
+
+    make_bmp_header(out, width, height, image_size > UINT32_MAX ? 0 : image_size);
+    *bmp = out;
+    out = NULL;
+    ret = e_success;
+    goto out;
+
+truncated:
+    printf("❌ ERROR: PNG image is truncated or corrupted!\n");
+out:
+    if (inflating)
+        inflateEnd(&zs);
+    free(in);
+    free(rows);
+    free(out);
+    if (ret != e_success)
+        *bmp_size = 0;
+    return ret;
+}
+
+/* ---------------------------------------------------------------
+ * 🗜️ Parallel PNG encoding
+ * --------------------------------------------------------------- */
+
+/* One deflate job: PNG_DEFLATE_CHUNK filtered bytes */
+typedef struct PngJob
+{
+    unsigned char *out;//raw deflate data, byte aligned at the end
+    size_t out_len;
+    uLong adler;//adler32 of the uncompressed input
+    uLong crc;//crc32 of out
+} PngJob;
+
+typedef struct PngEncoder
+{
+    const unsigned char *pixels;//first row in the BMP file
+    size_t row_bytes;
+    uint32_t width, height;
+    int top_down;
+    unsigned char *filtered;//height * (1 + row_bytes) scanlines
+    size_t filtered_size;
+    PngJob *jobs;
+    size_t njobs;
+    size_t next;//next job to take, shared by the workers
+    int failed;
+} PngEncoder;
+
+ // Function: bgr_row
+ // Purpose : PNG row y of the image, converted from the BMP row to RGB
+static void bgr_row(const PngEncoder *enc, uint32_t y, unsigned char *rgb)
+{
+    const unsigned char *src = enc->pixels + (size_t)(enc->top_down ? y : enc->height - 1 - y) * enc->row_bytes;
+
+    for (size_t x = 0; x < enc->row_bytes; x += 3)
+    {
+        rgb[x] = src[x + 2];
+        rgb[x + 1] = src[x + 1];
+        rgb[x + 2] = src[x];
+    }
+}
+
+ // Function: filter_row
+ // Purpose : Pick the filter with the smallest sum of signed bytes, like libpng
+static void filter_row(const unsigned char *cur, const unsigned char *prev, size_t n, unsigned char *cand, unsigned char *dest)
+{
+    unsigned char *sub = cand, *up = cand + n, *avg = cand + 2 * n, *pae = cand + 3 * n;
+    uint64_t sum[5] = {0};
+
+    for (size_t i = 0; i < n; i++)
+    {
+        unsigned char left = i >= 3 ? cur[i - 3] : 0;
+        unsigned char up_left = i >= 3 ? prev[i - 3] : 0;
+
+        sub[i] = cur[i] - left;
+        up[i] = cur[i] - prev[i];
+        avg[i] = cur[i] - ((left + prev[i]) >> 1);
+        pae[i] = cur[i] - paeth(left, prev[i], up_left);
+
+        sum[0] += abs((signed char)cur[i]);
+        sum[1] += abs((signed char)sub[i]);
+        sum[2] += abs((signed char)up[i]);
+        sum[3] += abs((signed char)avg[i]);
+        sum[4] += abs((signed char)pae[i]);
+    }
+
+    const unsigned char *filtered[5] = {cur, sub, up, avg, pae};
+    int best = 0;
+    for (int f = 1; f < 5; f++)
+        if (sum[f] < sum[best])
+            best = f;
+
+    dest[0] = best;
+    memcpy(dest + 1, filtered[best], n);
+}
+
+ // Function: png_filter_worker
+ // Purpose : Filter blocks of PNG_FILTER_ROWS scanlines until none are left
+static void *png_filter_worker(void *arg)
+{
+    PngEncoder *enc = arg;
+    size_t n = enc->row_bytes;
+    size_t nblocks = (enc->height + PNG_FILTER_ROWS - 1) / PNG_FILTER_ROWS;
+    unsigned char *scratch = malloc(6 * n);
+
+    if (scratch == NULL)
+    {
+        __atomic_store_n(&enc->failed, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+
+    for (;;)
+    {
+        size_t block = __atomic_fetch_add(&enc->next, 1, __ATOMIC_RELAXED);
+        if (block >= nblocks)
+            break;
+
+        unsigned char *prev = scratch, *cur = scratch + n;
+        uint32_t y = block * PNG_FILTER_ROWS;
+        uint32_t end = y + PNG_FILTER_ROWS < enc->height ? y + PNG_FILTER_ROWS : enc->height;
+
+        // Blocks are independent: rebuild the row above the first one
+        if (y == 0)
+            memset(prev, 0, n);
+        else
+            bgr_row(enc, y - 1, prev);
+
+        for (; y < end; y++)
+        {
+            bgr_row(enc, y, cur);
+            filter_row(cur, prev, n, scratch + 2 * n, enc->filtered + (size_t)y * (n + 1));
+
+            unsigned char *tmp = prev;
+            prev = cur;
+            cur = tmp;
+        }
+    }
+
+    free(scratch);
+    return NULL;
+}
+
+ // Function: png_deflate_worker
+ // Purpose : Deflate jobs until none are left, each primed with the 32K before it
+static void *png_deflate_worker(void *arg)
+{
+    PngEncoder *enc = arg;
+    z_stream zs;
+
+    memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, PNG_DEFLATE_LEVEL, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        __atomic_store_n(&enc->failed, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+
+    for (;;)
+    {
+        size_t j = __atomic_fetch_add(&enc->next, 1, __ATOMIC_RELAXED);
+        if (j >= enc->njobs)
+            break;
+
+        PngJob *job = &enc->jobs[j];
+        size_t start = j * PNG_DEFLATE_CHUNK;
+        size_t len = enc->filtered_size - start < PNG_DEFLATE_CHUNK ? enc->filtered_size - start : PNG_DEFLATE_CHUNK;
+        int last = (j == enc->njobs - 1);
+
+        deflateReset(&zs);
+        if (start > 0)
+        {
+            size_t dict = start < PNG_DEFLATE_DICT ? start : PNG_DEFLATE_DICT;
+            deflateSetDictionary(&zs, enc->filtered + start - dict, dict);
+        }
+
+        // Room for the worst case plus the empty stored block of the sync flush
+        size_t cap = deflateBound(&zs, len) + 16;
+        job->out = malloc(cap);
+        if (job->out == NULL)
+        {
+            __atomic_store_n(&enc->failed, 1, __ATOMIC_RELAXED);
+            break;
+        }
+
+        zs.next_in = enc->filtered + start;
+        zs.avail_in = len;
+        zs.next_out = job->out;
+        zs.avail_out = cap;
+
+        // Every job but the last ends on a byte boundary without a final block
+        int z = deflate(&zs, last ? Z_FINISH : Z_SYNC_FLUSH);
+        if ((last && z != Z_STREAM_END) || (!last && (z != Z_OK || zs.avail_in != 0 || zs.avail_out == 0)))
+        {
+            __atomic_store_n(&enc->failed, 1, __ATOMIC_RELAXED);
+            break;
+        }
+
+        job->out_len = cap - zs.avail_out;
+        job->adler = adler32(1L, enc->filtered + start, len);
+        job->crc = crc32(0L, job->out, job->out_len);
+    }
+
+    deflateEnd(&zs);
+    return NULL;
+}
+
+ // Function: png_run_workers
+ // Purpose : Run a worker on up to threads threads, the caller being one of them
+static void png_run_workers(void *(*worker)(void *), PngEncoder *enc, int threads)
+{
+    pthread_t tid[PNG_MAX_THREADS];
+    int started = 0;
+
+    enc->next = 0;
+    for (int i = 1; i < threads; i++)
+    {
+        if (pthread_create(&tid[started], NULL, worker, enc) == 0)
+            started++;
+    }
+
+    // Jobs are taken from a shared counter, so threads that failed to start cost nothing
+    worker(enc);
+
+    for (int i = 0; i < started; i++)
+        pthread_join(tid[i], NULL);
+}
+
+ // Function: png_write_chunk
+ // Purpose : Write one small chunk (IHDR, IEND) with its CRC
+static int png_write_chunk(FILE *fptr_png, const char *type, const unsigned char *data, uint32_t len)
+{
+    unsigned char head[8], crc_buf[4];
+
+    put_be32(head, len);
+    memcpy(head + 4, type, 4);
+    put_be32(crc_buf, crc32(crc32(0L, head + 4, 4), data, len));
+
+    return fwrite(head, 1, 8, fptr_png) == 8 &&
+           fwrite(data, 1, len, fptr_png) == len &&
+           fwrite(crc_buf, 1, 4, fptr_png) == 4;
+}
+
+ // Function: png_encode_from_bmp
+ // Purpose : Filter and deflate in parallel, then write one IDAT per job
+Status png_encode_from_bmp(const unsigned char *bmp, size_t bmp_size, FILE *fptr_png, int threads)
+{
+    PngEncoder enc;
+    int32_t width, height;
+    uint32_t offset, compression;
+    uint16_t bpp;
+    Status ret = e_failure;
+
+    memset(&enc, 0, sizeof(enc));
+
+    if (bmp_size < BMP_HEADER_SIZE || bmp[0] != 'B' || bmp[1] != 'M')
+    {
+        printf("❌ ERROR: No BMP data to write as PNG!\n");
+        return e_failure;
+    }
+
+    memcpy(&offset, bmp + 10, sizeof(offset));
+    memcpy(&width, bmp + 18, sizeof(width));
+    memcpy(&height, bmp + 22, sizeof(height));
+    memcpy(&bpp, bmp + 28, sizeof(bpp));
+    memcpy(&compression, bmp + 30, sizeof(compression));
+
+    enc.top_down = height < 0;
+    if (height < 0)
+        height = -height;
+    if (bpp != 24 || compression != 0 || width <= 0 || height <= 0 || offset < BMP_HEADER_SIZE)
+    {
+        printf("❌ ERROR: Only 24 bpp uncompressed images can be written as PNG!\n");
+        return e_failure;
+    }
+
+    enc.width = width;
+    enc.height = height;
+    enc.row_bytes = (size_t)width * 3;
+
+    // Padding bytes may carry payload bits and PNG has no place to keep them
+    if (bmp_row_stride((const char *)bmp) != enc.row_bytes)
+    {
+        printf("❌ ERROR: Padded BMP rows (width not a multiple of 4) cannot be written as PNG!\n");
+        return e_failure;
+    }
+    if (offset > bmp_size || (bmp_size - offset) / enc.row_bytes < (size_t)height)
+    {
+        printf("❌ ERROR: BMP data is truncated!\n");
+        return e_failure;
+    }
+    enc.pixels = bmp + offset;
+
+    enc.filtered_size = (size_t)height * (enc.row_bytes + 1);
+    enc.njobs = (enc.filtered_size + PNG_DEFLATE_CHUNK - 1) / PNG_DEFLATE_CHUNK;
+    enc.filtered = malloc(enc.filtered_size);
+    enc.jobs = calloc(enc.njobs, sizeof(*enc.jobs));
+    if (enc.filtered == NULL || enc.jobs == NULL)
+        goto out;
+
+    if (threads <= 0)
+        threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads > PNG_MAX_THREADS)
+        threads = PNG_MAX_THREADS;
+    if ((size_t)threads > enc.njobs)
+        threads = enc.njobs;
+    if (threads < 1)
+        threads = 1;
+
+    printf("🗜️  Compressing PNG with %d thread(s)...\n", threads);
+
+    png_run_workers(png_filter_worker, &enc, threads);
+    if (!enc.failed)
+        png_run_workers(png_deflate_worker, &enc, threads);
+    if (enc.failed)
+    {
+        printf("❌ ERROR: PNG compression failed!\n");
+        goto out;
+    }
+
+    unsigned char ihdr[13] = {0};
+    put_be32(ihdr, enc.width);
+    put_be32(ihdr + 4, enc.height);
+    ihdr[8] = 8;//bit depth
+    ihdr[9] = 2;//truecolour
+
+    if (fwrite(png_signature, 1, PNG_SIGNATURE_SIZE, fptr_png) != PNG_SIGNATURE_SIZE ||
+        !png_write_chunk(fptr_png, "IHDR", ihdr, sizeof(ihdr)))
+        goto out;
+
+    // The zlib trailer covers the whole stream: combine the per job checksums
+    uLong adler = adler32(0L, NULL, 0);
+    for (size_t j = 0; j < enc.njobs; j++)
+    {
+        size_t len = j == enc.njobs - 1 ? enc.filtered_size - j * PNG_DEFLATE_CHUNK : PNG_DEFLATE_CHUNK;
+        adler = adler32_combine(adler, enc.jobs[j].adler, len);
+    }
+
+    for (size_t j = 0; j < enc.njobs; j++)
+    {
+        PngJob *job = &enc.jobs[j];
+        size_t pre = j == 0 ? sizeof(zlib_header) : 0;
+        size_t post = j == enc.njobs - 1 ? 4 : 0;
+        unsigned char head[8], trailer[4], crc_buf[4];
+
+        put_be32(head, pre + job->out_len + post);
+        memcpy(head + 4, "IDAT", 4);
+        put_be32(trailer, adler);
+
+        // The chunk CRC is stitched from the one each worker computed
+        uLong crc = crc32(0L, head + 4, 4);
+        crc = crc32(crc, zlib_header, pre);
+        crc = crc32_combine(crc, job->crc, job->out_len);
+        crc = crc32(crc, trailer, post);
+        put_be32(crc_buf, crc);
+
+        if (fwrite(head, 1, 8, fptr_png) != 8 ||
+            fwrite(zlib_header, 1, pre, fptr_png) != pre ||
+            fwrite(job->out, 1, job->out_len, fptr_png) != job->out_len ||
+            fwrite(trailer, 1, post, fptr_png) != post ||
+            fwrite(crc_buf, 1, 4, fptr_png) != 4)
+            goto out;
+
+        free(job->out);
+        job->out = NULL;
+    }
+
+    if (!png_write_chunk(fptr_png, "IEND", (const unsigned char *)"", 0))
+        goto out;
+
+    printf("🗜️  PNG image written successfully!\n");
+    ret = e_success;
+
+out:
+    if (enc.jobs)
+        for (size_t j = 0; j < enc.njobs; j++)
+            free(enc.jobs[j].out);
+    free(enc.jobs);
+    free(enc.filtered);
+    return ret;
+}
+
+/* ---------------------------------------------------------------
+ * 🔁 BMP view streams over PNG files
+ * --------------------------------------------------------------- */
+
+typedef struct PngStream
+{
+    unsigned char *data;//the BMP view
+    size_t size;
+    size_t capacity;
+    size_t pos;
+    FILE *fptr_png;//output PNG, NULL when reading
+} PngStream;
+
+static ssize_t png_stream_read(void *cookie, char *buf, size_t n)
+{
+    PngStream *stream = cookie;
+
+    if (stream->pos >= stream->size)
+        return 0;
+    if (n > stream->size - stream->pos)
+        n = stream->size - stream->pos;
+    memcpy(buf, stream->data + stream->pos, n);
+    stream->pos += n;
+    return n;
+}
+
+static ssize_t png_stream_write(void *cookie, const char *buf, size_t n)
+{
+    PngStream *stream = cookie;
+
+    if (stream->pos + n > stream->capacity)
+    {
+        size_t capacity = stream->capacity * 2;
+        if (capacity < stream->pos + n)
+            capacity = stream->pos + n;
+
+        // Once the header comes in, reserve the whole image instead of doubling
+        if (stream->size == 0 && n >= 6 && buf[0] == 'B' && buf[1] == 'M')
+        {
+            uint32_t file_size;
+            memcpy(&file_size, buf + 2, sizeof(file_size));
+            if (file_size > capacity)
+                capacity = file_size;
+        }
+
+        unsigned char *data = realloc(stream->data, capacity);
+        if (data == NULL)
+            return 0;
+        stream->data = data;
+        stream->capacity = capacity;
+    }
+
+    if (stream->pos > stream->size)
+        memset(stream->data + stream->size, 0, stream->pos - stream->size);
+    memcpy(stream->data + stream->pos, buf, n);
+    stream->pos += n;
+    if (stream->pos > stream->size)
+        stream->size = stream->pos;
+    return n;
+}
+
+static int png_stream_seek(void *cookie, off64_t *offset, int whence)
+{
+    PngStream *stream = cookie;
+    off64_t base = whence == SEEK_SET ? 0 : whence == SEEK_CUR ? (off64_t)stream->pos : (off64_t)stream->size;
+
+    if (base + *offset < 0)
+        return -1;
+    stream->pos = base + *offset;
+    *offset = stream->pos;
+    return 0;
+}
+
+static int png_stream_close(void *cookie)
+{
+    PngStream *stream = cookie;
+    int ret = 0;
+
+    // Closing an output stream is what compresses and writes the PNG
+    if (stream->fptr_png)
+    {
+        if (png_encode_from_bmp(stream->data, stream->size, stream->fptr_png, 0) != e_success)
+            ret = -1;
+        if (fclose(stream->fptr_png) != 0)
+            ret = -1;
+    }
+
+    free(stream->data);
+    free(stream);
+    return ret;
+}
+
+ // Function: png_input_stream
+ // Purpose : Decode a whole PNG and serve its BMP view through a FILE
+FILE *png_input_stream(FILE *fptr_png)
+{
+    cookie_io_functions_t io = {png_stream_read, NULL, png_stream_seek, png_stream_close};
+    PngStream *stream = calloc(1, sizeof(*stream));
+
+    if (stream == NULL || png_decode_to_bmp(fptr_png, &stream->data, &stream->size) != e_success)
+    {
+        free(stream);
+        fclose(fptr_png);
+        return NULL;
+    }
+    fclose(fptr_png);
+
+    FILE *fptr = fopencookie(stream, "rb", io);
+    if (fptr == NULL)
+    {
+        free(stream->data);
+        free(stream);
+    }
+    return fptr;
+}
+
+ // Function: png_load_bmp
+ // Purpose : Decode a PNG file into a BMP view the caller keeps and frees
+Status png_load_bmp(const char *fname, unsigned char **bmp, size_t *bmp_size)
+{
+    FILE *fptr_png = open_input_stream(fname);
+
+    if (fptr_png == NULL)
+        return e_failure;
+    Status ret = png_decode_to_bmp(fptr_png, bmp, bmp_size);
+    fclose(fptr_png);
+    return ret;
+}
+
+ // Function: png_output_stream
+ // Purpose : Collect the BMP written to the FILE, encode it as PNG on fclose
+FILE *png_output_stream(FILE *fptr_png)
+{
+    cookie_io_functions_t io = {png_stream_read, png_stream_write, png_stream_seek, png_stream_close};
+    PngStream *stream = calloc(1, sizeof(*stream));
+
+    if (stream == NULL)
+    {
+        fclose(fptr_png);
+        return NULL;
+    }
+    stream->fptr_png = fptr_png;
+
+    FILE *fptr = fopencookie(stream, "wb", io);
+    if (fptr == NULL)
+    {
+        free(stream);
+        fclose(fptr_png);
+    }
+    return fptr;
+}
+
+ // Function: open_image_input
+ // Purpose : open_input_stream, with PNG files decoded into a BMP view
+FILE *open_image_input(const char *fname)
+{
+    FILE *fptr = open_input_stream(fname);
+
+    if (fptr != NULL && is_png_name(fname))
+        return png_input_stream(fptr);
+    return fptr;
+}
+
+ // Function: open_image_output
+ // Purpose : "-" is stdout, .png names are encoded as PNG when closed
+FILE *open_image_output(const char *fname, off_t expected_size, int flags)
+{
+    if (is_stream_name(fname))
+        return stdout_data_stream();
+
+    // The compressed size of a PNG is not known up front
+    FILE *fptr = open_bulk_output(fname, is_png_name(fname) ? 0 : expected_size, flags);
+    if (fptr != NULL && is_png_name(fname))
+        return png_output_stream(fptr);
+    return fptr;
+}
@@ -0,0 +1,65 @@
+/* Name : Shobharaj H L
+   Date : 12/11/2025
+   Description : LSB_IMAGE_STEGANOGRAPHY */
+#ifndef PNG_H
+#define PNG_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include "typese.h" // Contains user defined types
+
+/*
+ * PNG covers and stego images. A PNG is decoded into an in-memory
+ * 24 bpp BMP view (bottom-up, BGR) so every encode/decode step runs
+ * unchanged on the decoded scanlines. Rows of the view are packed
+ * (no padding) and say so through biSizeImage, so every byte that
+ * may carry payload survives the trip back to PNG.
+ *
+ * Output is compressed pigz style: the filtered scanlines are cut
+ * into PNG_DEFLATE_CHUNK pieces deflated by several threads, each
+ * primed with the previous 32K as dictionary and ended on a byte
+ * boundary, then stitched into one zlib stream.
+ */
+
+#define PNG_EXTN ".png"
+#define PNG_SIGNATURE_SIZE 8
+#define PNG_DEFLATE_CHUNK (128 * 1024) // uncompressed bytes per deflate job
+#define PNG_DEFLATE_DICT (32 * 1024) // deflate window carried between jobs
+#define PNG_DEFLATE_LEVEL 6
+#define PNG_FILTER_ROWS 16 // scanlines filtered per job
+#define PNG_IO_CHUNK (64 * 1024) // compressed bytes read at a time
+#define PNG_MAX_THREADS 32
+
+
+/* PNG function prototype */
+
+/* Check whether a file name means a PNG image */
+int is_png_name(const char *fname);
+
+/* Bytes per row of a 24 bpp BMP, packed when biSizeImage says so */
+size_t bmp_row_stride(const char *bmp_header);
+
+/* Decode a PNG into a malloc'ed 24 bpp BMP view */
+Status png_decode_to_bmp(FILE *fptr_png, unsigned char **bmp, size_t *bmp_size);
+
+/* Encode a 24 bpp BMP image as PNG, threads <= 0 uses every CPU */
+Status png_encode_from_bmp(const unsigned char *bmp, size_t bmp_size, FILE *fptr_png, int threads);
+
+/* Decode an opened PNG (closed here) and return a stream over its BMP view */
+FILE *png_input_stream(FILE *fptr_png);
+
+/* Open an image for reading, PNG files are read through a BMP view */
+FILE *open_image_input(const char *fname);
+
+/* Decode a PNG file into a malloc'ed 24 bpp BMP view owned by the caller */
+Status png_load_bmp(const char *fname, unsigned char **bmp, size_t *bmp_size);
+
+/* Wrap an opened output so BMP data written to it lands as PNG on fclose */
+FILE *png_output_stream(FILE *fptr_png);
+
+/* Open an image for writing, "-" is stdout and .png names get a PNG.
+   expected_size and flags (OUTPUT_*) are passed on to open_bulk_output */
+FILE *open_image_output(const char *fname, off_t expected_size, int flags);
+
+#endif
@@ -0,0 +1,537 @@
+/* Name : Shobharaj H L
+   Date : 12/11/2025
+   Description : LSB_IMAGE_STEGANOGRAPHY */
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "rs.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#endif
+
+static uint8_t gf_exp[512];
+static uint8_t gf_log[256];
+static uint8_t gf_mul_table[256][256];//full product table, one lookup per multiply
+#ifdef __SSE2__
+static uint8_t gf_nib_lo[256][16] __attribute__((aligned(16)));//c * x for the low nibble x, PSHUFB table
+static uint8_t gf_nib_hi[256][16] __attribute__((aligned(16)));//c * (x << 4) for the high nibble x
+static int have_ssse3;
+#endif
+static uint8_t gf_gen[RS_MAX_NSYM + 1][RS_MAX_NSYM + 1];//generator polynomial per nsym, highest degree first
+static pthread_once_t gf_once = PTHREAD_ONCE_INIT;
+
+/* ---------------------------------------------------------------
+ * 🧮 Build log/exp, product and generator tables once
+ * --------------------------------------------------------------- */
+static void gf_init(void)
+{
+    unsigned x = 1;
+    for (int i = 0; i < 255; i++)
+    {
+        gf_exp[i] = x;
+        gf_log[x] = i;
+        x <<= 1;
+        if (x & 0x100)
+            x ^= 0x11d;
+    }
+    for (int i = 255; i < 512; i++)
+        gf_exp[i] = gf_exp[i - 255];
+
+    for (int a = 1; a < 256; a++)
+        for (int b = 1; b < 256; b++)
+            gf_mul_table[a][b] = gf_exp[gf_log[a] + gf_log[b]];
+
+#ifdef __SSE2__
+    // Split nibble tables: c * x = lo[x & 15] ^ hi[x >> 4], 16 products per PSHUFB pair
+    for (int c = 0; c < 256; c++)
+        for (int x = 0; x < 16; x++)
+        {
+            gf_nib_lo[c][x] = gf_mul_table[c][x];
+            gf_nib_hi[c][x] = gf_mul_table[c][x << 4];
+        }
+    have_ssse3 = __builtin_cpu_supports("ssse3");
+#endif
+
+    // g_(i+1)(x) = g_i(x) * (x - alpha^i)
+    gf_gen[0][0] = 1;
+    for (int n = 1; n <= RS_MAX_NSYM; n++)
+    {
+        uint8_t root = gf_exp[n - 1];
+        gf_gen[n][0] = 1;
+        for (int j = 1; j < n; j++)
+            gf_gen[n][j] = gf_gen[n - 1][j] ^ gf_mul_table[gf_gen[n - 1][j - 1]][root];
+        gf_gen[n][n] = gf_mul_table[gf_gen[n - 1][n - 1]][root];
+    }
+}
+
+static inline uint8_t gf_inv(uint8_t a)
+{
+    return gf_exp[255 - gf_log[a]];
+}
+
+/* ---------------------------------------------------------------
+ * ⚙️ Tables for one nsym: row f holds f * g_1 .. f * g_nsym
+ * --------------------------------------------------------------- */
+int rs_init(RsCode *code, int nsym)
+{
+    // Fewer than 2 parity bytes correct nothing, more do not fit the tables
+    if (nsym < 2 || nsym > RS_MAX_NSYM)
+        return -1;
+
+    pthread_once(&gf_once, gf_init);
+
+    memset(code, 0, sizeof(*code));
+    code->nsym = nsym;
+    for (int f = 0; f < 256; f++)
+        for (int j = 0; j < nsym; j++)
+            code->gen_mul[f][j] = gf_mul_table[f][gf_gen[nsym][j + 1]];
+    return 0;
+}
+
+#ifdef __SSE2__
+/* ---------------------------------------------------------------
+ * 🚀 SSE2 register: nvec xmm registers shifted one byte per step
+ * --------------------------------------------------------------- */
+static inline __attribute__((always_inline))
+void rs_encode_sse2(const RsCode *code, const uint8_t *msg, size_t k, uint8_t *reg, const int nvec)
+{
+    __m128i r[RS_MAX_NSYM / 16] = { 0 };
+
+    for (size_t i = 0; i < k; i++)
+    {
+        // Rows are padded past nsym, so the lanes above the register stay zero
+        const uint8_t *row = code->gen_mul[msg[i] ^ (uint8_t)_mm_cvtsi128_si32(r[0])];
+#pragma GCC unroll 8
+        for (int v = 0; v < nvec; v++)
+        {
+            __m128i carry = v + 1 < nvec ? _mm_slli_si128(r[v + 1], 15) : _mm_setzero_si128();
+            r[v] = _mm_or_si128(_mm_srli_si128(r[v], 1), carry);
+            r[v] = _mm_xor_si128(r[v], _mm_loadu_si128((const __m128i *)(row + 16 * v)));
+        }
+    }
+#pragma GCC unroll 8
+    for (int v = 0; v < nvec; v++)
+        _mm_storeu_si128((__m128i *)(reg + 16 * v), r[v]);
+}
+#endif
+
+/* ---------------------------------------------------------------
+ * 🔐 Encode: remainder of msg(x) * x^nsym divided by g(x)
+ * --------------------------------------------------------------- */
+void rs_encode(const RsCode *code, const uint8_t *msg, size_t k, uint8_t *parity)
+{
+    // Register padded with zeros so every step is a whole-vector shift and xor
+    uint8_t reg[RS_MAX_NSYM + 32] = { 0 };
+    int nsym = code->nsym;
+
+#ifdef __SSE2__
+    // The whole register lives in xmm registers, one specialised loop per width
+    switch ((nsym + 15) / 16)
+    {
+    case 1:
+    case 2: rs_encode_sse2(code, msg, k, reg, 2); break;
+    case 3: rs_encode_sse2(code, msg, k, reg, 3); break;
+    case 4: rs_encode_sse2(code, msg, k, reg, 4); break;
+    case 5: rs_encode_sse2(code, msg, k, reg, 5); break;
+    case 6: rs_encode_sse2(code, msg, k, reg, 6); break;
+    case 7: rs_encode_sse2(code, msg, k, reg, 7); break;
+    default: rs_encode_sse2(code, msg, k, reg, 8); break;
+    }
+#else
+    for (size_t i = 0; i < k; i++)
+    {
+        const uint8_t *row = code->gen_mul[msg[i] ^ reg[0]];
+        for (int j = 0; j < nsym; j++)
+            reg[j] = reg[j + 1] ^ row[j];
+    }
+#endif
+    memcpy(parity, reg, nsym);
+}
+
+/* ---------------------------------------------------------------
+ * 🔎 Syndromes and Chien search, 16 bytes at a time with PSHUFB
+ * --------------------------------------------------------------- */
+#ifdef __SSE2__
+static inline __attribute__((target("ssse3"))) __m128i gf_mul_vec(__m128i x, uint8_t c)
+{
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    __m128i lo = _mm_shuffle_epi8(_mm_load_si128((const __m128i *)gf_nib_lo[c]), _mm_and_si128(x, mask));
+    __m128i hi = _mm_shuffle_epi8(_mm_load_si128((const __m128i *)gf_nib_hi[c]),
+                                  _mm_and_si128(_mm_srli_epi64(x, 4), mask));
+    return _mm_xor_si128(lo, hi);
+}
+
+__attribute__((target("ssse3")))
+static void rs_syndromes_ssse3(const uint8_t *codeword, size_t n, int nsym, uint8_t *synd)
+{
+    // Zeros in front do not change c(x), and make the codeword whole vectors
+    uint8_t buf[RS_BLOCK_SIZE + 1] __attribute__((aligned(16))) = { 0 };
+    __m128i block[(RS_BLOCK_SIZE + 1) / 16];
+    uint8_t acc[16];
+    size_t pad = (16 - n % 16) % 16, nblocks = (n + pad) / 16;
+
+    memcpy(buf + pad, codeword, n);
+    for (size_t t = 0; t < nblocks; t++)
+        block[t] = _mm_load_si128((const __m128i *)(buf + 16 * t));
+
+    for (int j = 0; j < nsym; j++)
+    {
+        // Horner per lane with alpha^(16 j), lane l then still owes alpha^(j (15 - l))
+        uint8_t step = gf_exp[16 * j % 255], s = 0;
+        __m128i v = block[0];
+        for (size_t t = 1; t < nblocks; t++)
+            v = _mm_xor_si128(gf_mul_vec(v, step), block[t]);
+
+        _mm_storeu_si128((__m128i *)acc, v);
+        for (int l = 0; l < 16; l++)
+            s ^= gf_mul_table[gf_exp[j * (15 - l) % 255]][acc[l]];
+        synd[j] = s;
+    }
+}
+
+__attribute__((target("ssse3")))
+static void rs_chien_ssse3(const uint8_t *lambda, int L, size_t n, uint8_t *is_root)
+{
+    // term[i] lane l holds lambda_i * alpha^(-i e) for e = 16 t + l
+    __m128i term[RS_MAX_NSYM / 2 + 1];
+    uint8_t start[16];
+
+    for (int i = 0; i <= L; i++)
+    {
+        for (int l = 0; l < 16; l++)
+            start[l] = gf_mul_table[lambda[i]][gf_exp[(255 - i * l % 255) % 255]];
+        term[i] = _mm_loadu_si128((const __m128i *)start);
+    }
+
+    for (size_t e = 0; e < n; e += 16)
+    {
+        __m128i val = term[0];
+        for (int i = 1; i <= L; i++)
+        {
+            val = _mm_xor_si128(val, term[i]);
+            term[i] = gf_mul_vec(term[i], gf_exp[(255 - 16 * i % 255) % 255]);
+        }
+        _mm_storeu_si128((__m128i *)(is_root + e), _mm_cmpeq_epi8(val, _mm_setzero_si128()));
+    }
+}
+#endif
+
+ // Function: rs_syndromes
+ // Purpose : S_j = c(alpha^j); codeword[0] is the highest power of x
+static void rs_syndromes(const uint8_t *codeword, size_t n, int nsym, uint8_t *synd)
+{
+#ifdef __SSE2__
+    if (have_ssse3)
+    {
+        rs_syndromes_ssse3(codeword, n, nsym, synd);
+        return;
+    }
+#endif
+    for (int j = 0; j < nsym; j++)
+    {
+        uint8_t s = 0;
+        const uint8_t *row_root = gf_mul_table[gf_exp[j]];
+        for (size_t i = 0; i < n; i++)
+            s = row_root[s] ^ codeword[i];
+        synd[j] = s;
+    }
+}
+
+ // Function: rs_chien
+ // Purpose : is_root[e] nonzero where Lambda(alpha^-e) == 0, for e < n
+static void rs_chien(const uint8_t *lambda, int L, size_t n, uint8_t *is_root)
+{
+#ifdef __SSE2__
+    if (have_ssse3)
+    {
+        rs_chien_ssse3(lambda, L, n, is_root);
+        return;
+    }
+#endif
+    for (size_t e = 0; e < n; e++)
+    {
+        uint8_t xinv = gf_exp[(255 - e) % 255];
+        uint8_t val = 0, xp = 1;
+        for (int i = 0; i <= L; i++)
+        {
+            val ^= gf_mul_table[lambda[i]][xp];
+            xp = gf_mul_table[xp][xinv];
+        }
+        is_root[e] = val == 0;
+    }
+}
+
+/* ---------------------------------------------------------------
+ * 🩹 Decode: Berlekamp-Massey, Chien search, Forney from the syndromes
+ * --------------------------------------------------------------- */
+static int rs_solve(const RsCode *code, uint8_t *codeword, size_t n, const uint8_t *synd)
+{
+    int nsym = code->nsym;
+    uint8_t lambda[RS_MAX_NSYM + 1] = { 1 }, prev[RS_MAX_NSYM + 1] = { 1 }, tmp[RS_MAX_NSYM + 1];
+    uint8_t omega[RS_MAX_NSYM];
+    uint8_t is_root[RS_BLOCK_SIZE + 16];//Chien writes whole vectors
+    int errors = 0;
+
+    // Berlekamp-Massey, polynomials in ascending powers; prev has degree <= Lp
+    int L = 0, Lp = 0, m = 1;
+    uint8_t b = 1;
+    for (int r = 0; r < nsym; r++)
+    {
+        uint8_t d = synd[r];
+        for (int i = 1; i <= L; i++)
+            d ^= gf_mul_table[lambda[i]][synd[r - i]];
+
+        if (d == 0)
+        {
+            m++;
+            continue;
+        }
+
+        uint8_t coef = gf_mul_table[d][gf_inv(b)];
+        if (2 * L <= r)
+        {
+            memcpy(tmp, lambda, sizeof(tmp));
+            for (int i = 0; i <= Lp && i + m <= nsym; i++)
+                lambda[i + m] ^= gf_mul_table[coef][prev[i]];
+            Lp = L;
+            L = r + 1 - L;
+            memcpy(prev, tmp, sizeof(prev));
+            b = d;
+            m = 1;
+        }
+        else
+        {
+            for (int i = 0; i <= Lp && i + m <= nsym; i++)
+                lambda[i + m] ^= gf_mul_table[coef][prev[i]];
+            m++;
+        }
+    }
+    if (2 * L > nsym)
+        return -1;
+
+    // Omega(x) = S(x) * Lambda(x) mod x^nsym, below degree L for a correctable block
+    for (int i = 0; i < L; i++)
+    {
+        uint8_t v = 0;
+        for (int j = 0; j <= i && j <= L; j++)
+            v ^= gf_mul_table[lambda[j]][synd[i - j]];
+        omega[i] = v;
+    }
+
+    // Chien search over the (possibly shortened) codeword
+    rs_chien(lambda, L, n, is_root);
+    for (size_t pos = 0; pos < n; pos++)
+    {
+        int e = n - 1 - pos;//power of x at this position
+        if (!is_root[e])
+            continue;
+
+        // Forney: e = X * Omega(X^-1) / Lambda'(X^-1), powers of X^-1 straight from gf_exp
+        int log_xinv = (255 - e) % 255;
+        uint8_t num = 0, den = 0;
+        for (int i = 0; i < L; i++)
+            num ^= gf_mul_table[omega[i]][gf_exp[i * log_xinv % 255]];
+        for (int i = 1; i <= L; i += 2)
+            den ^= gf_mul_table[lambda[i]][gf_exp[(i * log_xinv + e) % 255]];
+        if (den == 0)
+            return -1;
+
+        codeword[pos] ^= gf_mul_table[gf_mul_table[gf_exp[e]][num]][gf_inv(den)];
+        errors++;
+    }
+
+    // Roots outside the codeword mean more errors than we can fix
+    return errors == L ? errors : -1;
+}
+
+ // Function: rs_correct
+ // Purpose : One codeword: parity check first, the full decoder only for damaged blocks
+int rs_correct(const RsCode *code, uint8_t *codeword, size_t n)
+{
+    int nsym = code->nsym;
+    uint8_t synd[RS_MAX_NSYM], tmp[RS_MAX_NSYM];
+    int nonzero = 0;
+
+    // Fast path: recompute the parity, clean blocks need nothing else
+    rs_encode(code, codeword, n - nsym, tmp);
+    if (memcmp(tmp, codeword + n - nsym, nsym) == 0)
+        return 0;
+
+    rs_syndromes(codeword, n, nsym, synd);
+    for (int j = 0; j < nsym; j++)
+        nonzero |= synd[j];
+    if (!nonzero)
+        return 0;
+    return rs_solve(code, codeword, n, synd);
+}
+
+/* ---------------------------------------------------------------
+ * 📦 Whole blocks, RS_BATCH codewords at once: lane l of every
+ *    vector belongs to codeword l, so each multiply by a constant
+ *    (generator coefficient or alpha^j) is one PSHUFB pair for all
+ * --------------------------------------------------------------- */
+#ifdef __SSE2__
+ // Function: transpose16
+ // Purpose : 16x16 byte transpose, r[l] byte t <-> r[t] byte l
+static inline void transpose16(__m128i *r)
+{
+    __m128i a[16], b[16];
+
+    for (int i = 0; i < 8; i++)
+    {
+        a[i] = _mm_unpacklo_epi8(r[2 * i], r[2 * i + 1]);
+        a[i + 8] = _mm_unpackhi_epi8(r[2 * i], r[2 * i + 1]);
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        b[i] = _mm_unpacklo_epi16(a[2 * i], a[2 * i + 1]);
+        b[i + 4] = _mm_unpackhi_epi16(a[2 * i], a[2 * i + 1]);
+        b[i + 8] = _mm_unpacklo_epi16(a[2 * i + 8], a[2 * i + 9]);
+        b[i + 12] = _mm_unpackhi_epi16(a[2 * i + 8], a[2 * i + 9]);
+    }
+    for (int q = 0; q < 4; q++)
+    {
+        __m128i c0 = _mm_unpacklo_epi32(b[4 * q], b[4 * q + 1]);
+        __m128i c1 = _mm_unpackhi_epi32(b[4 * q], b[4 * q + 1]);
+        __m128i c2 = _mm_unpacklo_epi32(b[4 * q + 2], b[4 * q + 3]);
+        __m128i c3 = _mm_unpackhi_epi32(b[4 * q + 2], b[4 * q + 3]);
+        r[4 * q] = _mm_unpacklo_epi64(c0, c2);
+        r[4 * q + 1] = _mm_unpackhi_epi64(c0, c2);
+        r[4 * q + 2] = _mm_unpacklo_epi64(c1, c3);
+        r[4 * q + 3] = _mm_unpackhi_epi64(c1, c3);
+    }
+}
+
+ // Function: load_columns
+ // Purpose : col[t] = byte pos + t of the 16 codewords, for t < width
+static inline void load_columns(const uint8_t *blocks, size_t pos, size_t width, __m128i *col)
+{
+    if (width == 16)
+    {
+        for (int l = 0; l < 16; l++)
+            col[l] = _mm_loadu_si128((const __m128i *)(blocks + l * RS_BLOCK_SIZE + pos));
+        transpose16(col);
+        return;
+    }
+
+    uint8_t lanes[16][16];
+    for (int l = 0; l < RS_BATCH; l++)
+        for (size_t t = 0; t < width; t++)
+            lanes[t][l] = blocks[l * RS_BLOCK_SIZE + pos + t];
+    for (size_t t = 0; t < width; t++)
+        col[t] = _mm_loadu_si128((const __m128i *)lanes[t]);
+}
+
+__attribute__((target("ssse3")))
+static void rs_encode_batch_ssse3(const RsCode *code, const uint8_t *blocks, uint8_t parity[][16])
+{
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    const uint8_t *gen = code->gen_mul[1];//g_1 .. g_nsym
+    int nsym = code->nsym;
+    size_t k = RS_BLOCK_SIZE - nsym;
+    __m128i reg[RS_MAX_NSYM + 1], col[16];
+
+    for (int j = 0; j <= nsym; j++)
+        reg[j] = _mm_setzero_si128();
+
+    for (size_t pos = 0; pos < k; pos += 16)
+    {
+        size_t width = k - pos < 16 ? k - pos : 16;
+        load_columns(blocks, pos, width, col);
+
+        for (size_t t = 0; t < width; t++)
+        {
+            // Feedback byte of every codeword, split into nibbles once for all coefficients
+            __m128i f = _mm_xor_si128(col[t], reg[0]);
+            __m128i f_lo = _mm_and_si128(f, mask), f_hi = _mm_and_si128(_mm_srli_epi64(f, 4), mask);
+            for (int j = 0; j < nsym; j++)
+            {
+                __m128i p = _mm_xor_si128(_mm_shuffle_epi8(_mm_load_si128((const __m128i *)gf_nib_lo[gen[j]]), f_lo),
+                                          _mm_shuffle_epi8(_mm_load_si128((const __m128i *)gf_nib_hi[gen[j]]), f_hi));
+                reg[j] = _mm_xor_si128(reg[j + 1], p);
+            }
+        }
+    }
+
+    // parity[j] lane l: parity byte j of codeword l
+    for (int j = 0; j < nsym; j++)
+        _mm_storeu_si128((__m128i *)parity[j], reg[j]);
+}
+
+#endif
+
+ // Function: rs_encode_blocks
+ // Purpose : Parity for count whole codewords stored back to back
+void rs_encode_blocks(const RsCode *code, uint8_t *blocks, size_t count)
+{
+    size_t k = RS_BLOCK_SIZE - code->nsym, b = 0;
+
+#ifdef __SSE2__
+    uint8_t parity[RS_MAX_NSYM][16];
+
+    for (; have_ssse3 && b + RS_BATCH <= count; b += RS_BATCH)
+    {
+        rs_encode_batch_ssse3(code, blocks + b * RS_BLOCK_SIZE, parity);
+        for (int l = 0; l < RS_BATCH; l++)
+            for (int j = 0; j < code->nsym; j++)
+                blocks[(b + l) * RS_BLOCK_SIZE + k + j] = parity[j][l];
+    }
+#endif
+    for (; b < count; b++)
+        rs_encode(code, blocks + b * RS_BLOCK_SIZE, k, blocks + b * RS_BLOCK_SIZE + k);
+}
+
+ // Function: rs_correct_blocks
+ // Purpose : Batched parity check; only the damaged codewords go through the full decoder
+long rs_correct_blocks(const RsCode *code, uint8_t *blocks, size_t count, size_t *bad_block)
+{
+    size_t b = 0;
+    long fixed = 0;
+
+#ifdef __SSE2__
+    int nsym = code->nsym;
+    size_t k = RS_BLOCK_SIZE - nsym;
+    uint8_t parity[RS_MAX_NSYM][16], diff[RS_MAX_NSYM], synd[RS_MAX_NSYM];
+
+    for (; have_ssse3 && b + RS_BATCH <= count; b += RS_BATCH)
+    {
+        rs_encode_batch_ssse3(code, blocks + b * RS_BLOCK_SIZE, parity);
+
+        for (int l = 0; l < RS_BATCH; l++)
+        {
+            uint8_t *codeword = blocks + (b + l) * RS_BLOCK_SIZE;
+            int nonzero = 0;
+            for (int j = 0; j < nsym; j++)
+            {
+                diff[j] = parity[j][l] ^ codeword[k + j];
+                nonzero |= diff[j];
+            }
+            if (!nonzero)
+                continue;
+
+            // Codeword minus its re-encoding is zero outside the parity, so
+            // S_j = diff(alpha^j) with diff only nsym bytes long
+            rs_syndromes(diff, nsym, nsym, synd);
+            int n = rs_solve(code, codeword, RS_BLOCK_SIZE, synd);
+            if (n < 0)
+            {
+                *bad_block = b + l;
+                return -1;
+            }
+            fixed += n;
+        }
+    }
+#endif
+    for (; b < count; b++)
+    {
+        int n = rs_correct(code, blocks + b * RS_BLOCK_SIZE, RS_BLOCK_SIZE);
+        if (n < 0)
+        {
+            *bad_block = b;
+            return -1;
+        }
+        fixed += n;
+    }
+    return fixed;
+}
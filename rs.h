@@ -0,0 +1,46 @@
+/* Name : Shobharaj H L
+   Date : 12/11/2025
+   Description : LSB_IMAGE_STEGANOGRAPHY */
+#ifndef RS_H
+#define RS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Reed-Solomon over GF(256) (polynomial 0x11d, generator 2, first
+ * consecutive root 1 = alpha^0). A codeword is n <= 255 bytes: the
+ * message followed by nsym parity bytes; up to nsym / 2 wrong bytes
+ * anywhere in it are corrected.
+ */
+
+#define RS_BLOCK_SIZE 255
+#define RS_MAX_NSYM 128
+#define RS_DEFAULT_NSYM 32
+#define RS_BATCH 16 // codewords coded side by side, one per SIMD lane
+
+/* Per nsym tables, set up once with rs_init and shared read-only */
+typedef struct RsCode
+{
+    int nsym;//parity bytes per codeword
+    uint8_t gen_mul[256][RS_MAX_NSYM + 16];//feedback byte times generator, zero padded
+} RsCode;
+
+/* Prepare the tables for nsym parity bytes (2..RS_MAX_NSYM), -1 if out of range */
+int rs_init(RsCode *code, int nsym);
+
+/* Compute nsym parity bytes for msg[0..k-1], k + nsym <= 255 */
+void rs_encode(const RsCode *code, const uint8_t *msg, size_t k, uint8_t *parity);
+
+/* Correct codeword[0..n-1] in place, returns bytes fixed or -1 if too damaged */
+int rs_correct(const RsCode *code, uint8_t *codeword, size_t n);
+
+/* Fill in the parity of count whole codewords (RS_BLOCK_SIZE bytes each,
+   message first) stored back to back, RS_BATCH at a time */
+void rs_encode_blocks(const RsCode *code, uint8_t *blocks, size_t count);
+
+/* Correct count whole back to back codewords in place, returns bytes fixed,
+   or -1 with *bad_block set to the first one too damaged */
+long rs_correct_blocks(const RsCode *code, uint8_t *blocks, size_t count, size_t *bad_block);
+
+#endif
@@ -0,0 +1,74 @@
+/* Name : Shobharaj H L
+   Date : 12/11/2025
+   Description : LSB_IMAGE_STEGANOGRAPHY */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "rs.h"
+
+/*
+ * Reed-Solomon micro-benchmark: MB/s of message data through
+ * rs_encode_blocks and rs_correct_blocks for a few nsym values, clean
+ * blocks and blocks with nsym / 4 wrong bytes.
+ *   gcc -O2 -pthread rs_bench.c rs.c -o rs_bench && ./rs_bench [MB]
+ */
+
+#define BENCH_BLOCKS 4096
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[])
+{
+    static const int nsyms[] = { 16, 32, 64, 128 };
+    static uint8_t blocks[BENCH_BLOCKS][RS_BLOCK_SIZE], work[BENCH_BLOCKS][RS_BLOCK_SIZE];
+    static RsCode code;
+    int mb = argc > 1 ? atoi(argv[1]) : 64;
+
+    srand(1);
+    for (int b = 0; b < BENCH_BLOCKS; b++)
+        for (int i = 0; i < RS_BLOCK_SIZE; i++)
+            blocks[b][i] = rand();
+
+    printf("nsym   encode MB/s   correct MB/s (clean)   correct MB/s (nsym/4 errors)\n");
+    for (size_t s = 0; s < sizeof(nsyms) / sizeof(nsyms[0]); s++)
+    {
+        int nsym = nsyms[s], k = RS_BLOCK_SIZE - nsym;
+        long rounds = (long)mb * 1024 * 1024 / ((long)k * BENCH_BLOCKS) + 1;
+        double mbytes = (double)rounds * BENCH_BLOCKS * k / (1024 * 1024), t[3];
+        int failed = 0;
+
+        rs_init(&code, nsym);
+        t[0] = now();
+        for (long r = 0; r < rounds; r++)
+            rs_encode_blocks(&code, blocks[0], BENCH_BLOCKS);
+        t[0] = now() - t[0];
+
+        for (int pass = 1; pass <= 2; pass++)
+        {
+            t[pass] = 0;
+            for (long r = 0; r < rounds; r++)
+            {
+                memcpy(work, blocks, sizeof(work));
+                if (pass == 2)
+                    for (int b = 0; b < BENCH_BLOCKS; b++)
+                        for (int e = 0; e < nsym / 4; e++)
+                            work[b][(b * 7 + e * 37) % RS_BLOCK_SIZE] ^= 1 + e;
+                double start = now();
+                size_t bad;
+                failed |= rs_correct_blocks(&code, work[0], BENCH_BLOCKS, &bad) != (pass == 2 ? nsym / 4 * BENCH_BLOCKS : 0);
+                t[pass] += now() - start;
+            }
+            failed |= memcmp(work, blocks, sizeof(work)) != 0;
+        }
+
+        printf("%4d   %11.1f   %20.1f   %28.1f%s\n", nsym, mbytes / t[0], mbytes / t[1], mbytes / t[2],
+               failed ? "   ❌ wrong result" : "");
+    }
+    return 0;
+}
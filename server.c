@@ -0,0 +1,568 @@
+/* Name : Shobharaj H L
+   Date : 12/11/2025
+   Description : LSB_IMAGE_STEGANOGRAPHY */
+#define _GNU_SOURCE // accept4
+#define _FILE_OFFSET_BITS 64
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include "encode.h"
+#include "decode.h"
+#include "server.h"
+#include "stream.h"
+#include "png.h"
+#include "output.h"
+#include "rs.h"
+#include "typese.h"
+#include "common.h"
+
+/* Per worker state, allocated once and reused for every request */
+typedef struct ServerWorker
+{
+    pthread_t tid;
+    ServerRequest request;//last received request
+    char src_buf[SERVER_IO_BUF_SIZE];//stdio buffer for the input image
+    char secret_buf[SERVER_IO_BUF_SIZE];//stdio buffer for the secret file
+} ServerWorker;
+
+/* Accepted connections waiting for a worker */
+static struct
+{
+    int fds[SERVER_QUEUE_SIZE];
+    int head, count;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+} queue = { .lock = PTHREAD_MUTEX_INITIALIZER,
+            .not_empty = PTHREAD_COND_INITIALIZER,
+            .not_full = PTHREAD_COND_INITIALIZER };
+
+/* ---------------------------------------------------------------
+ * 📥 Connection queue helpers
+ * --------------------------------------------------------------- */
+static void queue_push(int fd)
+{
+    pthread_mutex_lock(&queue.lock);
+    while (queue.count == SERVER_QUEUE_SIZE)
+        pthread_cond_wait(&queue.not_full, &queue.lock);
+    queue.fds[(queue.head + queue.count) % SERVER_QUEUE_SIZE] = fd;
+    queue.count++;
+    pthread_cond_signal(&queue.not_empty);
+    pthread_mutex_unlock(&queue.lock);
+}
+
+static int queue_pop(void)
+{
+    pthread_mutex_lock(&queue.lock);
+    while (queue.count == 0)
+        pthread_cond_wait(&queue.not_empty, &queue.lock);
+    int fd = queue.fds[queue.head];
+    queue.head = (queue.head + 1) % SERVER_QUEUE_SIZE;
+    queue.count--;
+    pthread_cond_signal(&queue.not_full);
+    pthread_mutex_unlock(&queue.lock);
+    return fd;
+}
+
+/* ---------------------------------------------------------------
+ * 📂 Open a request file from a passed fd or from its path
+ * --------------------------------------------------------------- */
+static FILE *open_request_file(int fd, const char *fname, const char *mode, char *buf)
+{
+    FILE *fptr = (fd >= 0) ? fdopen(fd, mode) : fopen(fname, mode);
+    if (fptr == NULL)
+    {
+        if (fd >= 0)
+            close(fd);
+        return NULL;
+    }
+    setvbuf(fptr, buf, _IOFBF, SERVER_IO_BUF_SIZE);
+
+    // Same readahead hint as open_input_stream gives CLI inputs
+    posix_fadvise(fileno(fptr), 0, 0, POSIX_FADV_SEQUENTIAL);
+    return fptr;
+}
+
+/* ---------------------------------------------------------------
+ * 🔐 Encode job
+ * --------------------------------------------------------------- */
+static Status serve_encode(ServerWorker *worker, int *fds, int nfds, ServerReply *reply)
+{
+    ServerRequest *req = &worker->request;
+    EncodeInfo encInfo;
+    Status ret = e_failure;
+
+    // Raw requests skip the CLI checks, so repeat them before touching any file
+    if ((req->fec_nsym != 0 && (req->fec_nsym < 2 || req->fec_nsym > RS_MAX_NSYM)) ||
+        req->adaptive_threshold > 254 || (req->adaptive_threshold >= 0 && req->fec_nsym != 0))
+    {
+        snprintf(reply->message, SERVER_MSG_SIZE, "invalid request");
+        for (int i = 0; i < nfds; i++)
+            close(fds[i]);
+        return e_failure;
+    }
+
+    memset(&encInfo, 0, sizeof(encInfo));
+    encInfo.src_image_fname = req->src_fname;
+    encInfo.secret_fname = req->secret_fname;
+    encInfo.stego_image_fname = req->out_fname;
+    memcpy(encInfo.extn_secret_file, req->extn_secret_file, MAX_FILE_SUFFIX - 1);
+    encInfo.adaptive = req->adaptive_threshold >= 0;
+    encInfo.threshold = encInfo.adaptive ? req->adaptive_threshold : 0;
+    encInfo.fec_nsym = req->fec_nsym;
+
+    encInfo.fptr_src_image = open_request_file(nfds == 3 ? fds[0] : -1, req->src_fname, "rb", worker->src_buf);
+    encInfo.fptr_secret = open_request_file(nfds == 3 ? fds[1] : -1, req->secret_fname, "rb", worker->secret_buf);
+
+    // The output goes through the bulk writer, a BMP is reserved at the size of its cover
+    int out_fd = nfds == 3 ? fds[2] : open(req->out_fname, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out_fd >= 0 && encInfo.fptr_src_image)
+        encInfo.fptr_stego_image = bulk_output_fd(out_fd,
+                                                  is_png_name(req->out_fname) ? 0 : regular_file_size(encInfo.fptr_src_image),
+                                                  req->output_flags & (OUTPUT_DROP_CACHE | OUTPUT_DIRECT));
+    else if (out_fd >= 0)
+        close(out_fd);
+
+    // PNG images go through a BMP view, the output is compressed on fclose
+    if (encInfo.fptr_src_image && is_png_name(req->src_fname))
+        encInfo.fptr_src_image = png_input_stream(encInfo.fptr_src_image);
+    if (encInfo.fptr_stego_image && is_png_name(req->out_fname))
+        encInfo.fptr_stego_image = png_output_stream(encInfo.fptr_stego_image);
+
+    if (encInfo.fptr_src_image && encInfo.fptr_secret && encInfo.fptr_stego_image)
+        ret = do_encoding_opened(&encInfo);
+    else
+        snprintf(reply->message, SERVER_MSG_SIZE, "unable to open files: %s", strerror(errno));
+
+    if (encInfo.fptr_src_image)
+        fclose(encInfo.fptr_src_image);
+    if (encInfo.fptr_secret)
+        fclose(encInfo.fptr_secret);
+    if (encInfo.fptr_stego_image && fclose(encInfo.fptr_stego_image) != 0)
+        ret = e_failure;
+
+    // An output created here by name is ours to clean up, a passed one is removed by the client
+    if (ret != e_success && nfds == 0 && out_fd >= 0)
+        remove(req->out_fname);
+
+    if (ret == e_success)
+        snprintf(reply->message, SERVER_MSG_SIZE, "encoded into %.200s", req->out_fname[0] ? req->out_fname : "<fd>");
+    else if (reply->message[0] == '\0')
+        snprintf(reply->message, SERVER_MSG_SIZE, "encoding failed");
+    return ret;
+}
+
+/* ---------------------------------------------------------------
+ * 🔓 Decode and probe jobs
+ * --------------------------------------------------------------- */
+static Status serve_decode(ServerWorker *worker, int *fds, int nfds, ServerReply *reply)
+{
+    ServerRequest *req = &worker->request;
+    EncodeInfod encInfod;
+    Statusd ret = d_failure;
+
+    memset(&encInfod, 0, sizeof(encInfod));
+    encInfod.stego_image_fname = req->src_fname;
+
+    // Output name gets the decoded extension appended to it; checked for probes too, the buffer is the same
+    if (strlen(req->out_fname) + MAX_FILE_SUFFIX >= sizeof(encInfod.buf) || is_stream_name(req->out_fname))
+    {
+        snprintf(reply->message, SERVER_MSG_SIZE, "invalid output name");
+        if (nfds == 1)
+            close(fds[0]);
+        return e_failure;
+    }
+    snprintf(encInfod.buf, sizeof(encInfod.buf), "%s", req->out_fname);
+
+    encInfod.fptr_stego_image = open_request_file(nfds == 1 ? fds[0] : -1, req->src_fname, "rb", worker->src_buf);
+    if (encInfod.fptr_stego_image && is_png_name(req->src_fname))
+        encInfod.fptr_stego_image = png_input_stream(encInfod.fptr_stego_image);
+    if (encInfod.fptr_stego_image == NULL)
+    {
+        snprintf(reply->message, SERVER_MSG_SIZE, "unable to open %.160s: %s", req->src_fname, strerror(errno));
+        return e_failure;
+    }
+
+    if (req->op == SERVER_OP_PROBE)
+    {
+        ret = probe_stego_image(&encInfod);
+        snprintf(reply->message, SERVER_MSG_SIZE, ret == d_success ? "magic string found" : "no magic string");
+    }
+    else
+    {
+        ret = do_decoding(&encInfod);
+        if (ret == d_success)
+            snprintf(reply->message, SERVER_MSG_SIZE, "decoded into %.200s (%lld bytes)", encInfod.buf, (long long)encInfod.size_secret_file);
+        else
+            snprintf(reply->message, SERVER_MSG_SIZE, "decoding failed");
+    }
+
+    fclose(encInfod.fptr_stego_image);
+    if (encInfod.out_fptr)
+    {
+        // The decoded file is always created here, do not leave a partial one behind
+        if (fclose(encInfod.out_fptr) != 0 && ret == d_success)
+        {
+            snprintf(reply->message, SERVER_MSG_SIZE, "decoding failed");
+            ret = d_failure;
+        }
+        if (ret != d_success)
+            remove(encInfod.buf);
+    }
+    return ret == d_success ? e_success : e_failure;
+}
+
+/* ---------------------------------------------------------------
+ * 🔁 Serve every request sent on one connection
+ * --------------------------------------------------------------- */
+static void serve_connection(ServerWorker *worker, int conn)
+{
+    for (;;)
+    {
+        union
+        {
+            struct cmsghdr align;
+            char buf[CMSG_SPACE(3 * sizeof(int))];
+        } control;
+        struct iovec iov = { &worker->request, sizeof(worker->request) };
+        struct msghdr msg = { 0 };
+        int fds[3];
+        int nfds = 0;
+
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control.buf;
+        msg.msg_controllen = sizeof(control.buf);
+
+        // Times out after SERVER_IDLE_TIMEOUT, so idle peers cannot hold the pool
+        ssize_t n = recvmsg(conn, &msg, MSG_CMSG_CLOEXEC);
+        if (n <= 0)
+            break;
+
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+            {
+                int count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                for (int i = 0; i < count; i++)
+                {
+                    int fd;
+                    memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+                    if (nfds < 3)
+                        fds[nfds++] = fd;
+                    else
+                        close(fd);
+                }
+            }
+        }
+
+        ServerReply reply;
+        memset(&reply, 0, sizeof(reply));
+        ServerRequest *req = &worker->request;
+
+        if (n != sizeof(*req) || (msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)))
+        {
+            snprintf(reply.message, SERVER_MSG_SIZE, "malformed request");
+            reply.status = e_failure;
+            for (int i = 0; i < nfds; i++)
+                close(fds[i]);
+        }
+        else
+        {
+            req->src_fname[SERVER_PATH_MAX - 1] = '\0';
+            req->secret_fname[SERVER_PATH_MAX - 1] = '\0';
+            req->out_fname[SERVER_PATH_MAX - 1] = '\0';
+            req->extn_secret_file[sizeof(req->extn_secret_file) - 1] = '\0';
+
+            if (req->op == SERVER_OP_ENCODE && (nfds == 0 || nfds == 3))
+                reply.status = serve_encode(worker, fds, nfds, &reply);
+            else if ((req->op == SERVER_OP_DECODE || req->op == SERVER_OP_PROBE) && nfds <= 1)
+                reply.status = serve_decode(worker, fds, nfds, &reply);
+            else
+            {
+                snprintf(reply.message, SERVER_MSG_SIZE, "unsupported request");
+                reply.status = e_failure;
+                for (int i = 0; i < nfds; i++)
+                    close(fds[i]);
+            }
+        }
+
+        if (send(conn, &reply, sizeof(reply), MSG_NOSIGNAL) != sizeof(reply))
+            break;
+    }
+    close(conn);
+}
+
+static void *server_worker(void *arg)
+{
+    ServerWorker *worker = arg;
+    for (;;)
+        serve_connection(worker, queue_pop());
+    return NULL;
+}
+
+/* ---------------------------------------------------------------
+ * 🛰️ Listen on a Unix socket and hand connections to the pool
+ * --------------------------------------------------------------- */
+Status run_server(const char *socket_path, int workers)
+{
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (strlen(socket_path) >= sizeof(addr.sun_path))
+    {
+        fprintf(stderr, "❌ ERROR: Socket path too long %s\n", socket_path);
+        return e_failure;
+    }
+    strcpy(addr.sun_path, socket_path);
+
+    int sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (sock < 0)
+    {
+        perror("socket");
+        return e_failure;
+    }
+
+    // Requests open files with our privileges: only our own user may connect (socket mode 0600)
+    unlink(socket_path);
+    mode_t old_umask = umask(077);
+    int bound = bind(sock, (struct sockaddr *)&addr, sizeof(addr));
+    umask(old_umask);
+    if (bound < 0 || listen(sock, SERVER_QUEUE_SIZE) < 0)
+    {
+        perror("bind");
+        close(sock);
+        return e_failure;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+
+    if (workers <= 0)
+        workers = SERVER_WORKERS;
+    ServerWorker *pool = calloc(workers, sizeof(ServerWorker));
+    if (!pool)
+    {
+        close(sock);
+        return e_failure;
+    }
+
+    for (int i = 0; i < workers; i++)
+    {
+        if (pthread_create(&pool[i].tid, NULL, server_worker, &pool[i]) != 0)
+        {
+            fprintf(stderr, "❌ ERROR: Unable to start worker %d\n", i);
+            close(sock);
+            return e_failure;
+        }
+    }
+
+    printf("🛰️  Server listening on %s with %d workers\n", socket_path, workers);
+
+    for (;;)
+    {
+        int conn = accept4(sock, NULL, NULL, SOCK_CLOEXEC);
+        if (conn < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            perror("accept");
+            break;
+        }
+
+        // A worker serves one connection at a time: drop peers that stop sending
+        struct timeval idle = { .tv_sec = SERVER_IDLE_TIMEOUT };
+        setsockopt(conn, SOL_SOCKET, SO_RCVTIMEO, &idle, sizeof(idle));
+        queue_push(conn);
+    }
+
+    close(sock);
+    return e_failure;
+}
+
+/* ---------------------------------------------------------------
+ * 🧭 Turn a client side relative path into an absolute one
+ * --------------------------------------------------------------- */
+static Status absolute_path(char *dest, const char *path)
+{
+    char cwd[SERVER_PATH_MAX];
+
+    if (path[0] == '/')
+        return (size_t)snprintf(dest, SERVER_PATH_MAX, "%s", path) < SERVER_PATH_MAX ? e_success : e_failure;
+
+    if (getcwd(cwd, sizeof(cwd)) == NULL)
+        return e_failure;
+    return (size_t)snprintf(dest, SERVER_PATH_MAX, "%s/%s", cwd, path) < SERVER_PATH_MAX ? e_success : e_failure;
+}
+
+/* ---------------------------------------------------------------
+ * 🏷️ Only real paths mean the same thing to the client and the server
+ * --------------------------------------------------------------- */
+static int is_client_path(const char *fname)
+{
+    if (is_stream_name(fname) || strncmp(fname, STREAM_FD_PREFIX, strlen(STREAM_FD_PREFIX)) == 0)
+    {
+        printf("⚠️  ERROR: %s is not a file name, streams cannot be used with -c\n", fname);
+        return 0;
+    }
+    return 1;
+}
+
+/* ---------------------------------------------------------------
+ * 📨 Client: validate args like the CLI and pass the files as fds
+ * --------------------------------------------------------------- */
+Status run_client(const char *socket_path, int argc, char *argv[])
+{
+    ServerRequest *req = calloc(1, sizeof(ServerRequest));
+    EncodeInfo encInfo;
+    EncodeInfod encInfod;
+    int fds[3] = { -1, -1, -1 };
+    int nfds = 0;
+    Status ret = e_failure;
+
+    if (!req)
+        return e_failure;
+
+    if (argc >= 3 && strcmp(argv[1], "-p") == 0)
+    {
+        if (!is_client_path(argv[2]))
+        {
+            free(req);
+            return e_failure;
+        }
+        req->op = SERVER_OP_PROBE;
+        absolute_path(req->src_fname, argv[2]);
+        fds[nfds++] = open(argv[2], O_RDONLY | O_CLOEXEC);
+    }
+    else if (check_operation_type(argv, argc) == e_encode)
+    {
+        if (read_and_validate_encode_args(argc, argv, &encInfo) != e_success)
+        {
+            printf("Usage: ./a.out -c <socket> -e <source.bmp|.png> <secret.txt> [output.bmp|.png] [--adaptive[=threshold] | --fec[=nsym]] [--drop-cache] [--direct]\n");
+            free(req);
+            return e_failure;
+        }
+        if (!is_client_path(encInfo.src_image_fname) || !is_client_path(encInfo.secret_fname) ||
+            !is_client_path(encInfo.stego_image_fname))
+        {
+            free(req);
+            return e_failure;
+        }
+        // The run is measured in the server process, the client has nothing to report
+        if (encInfo.output_flags & OUTPUT_STATS)
+        {
+            printf("⚠️  ERROR: --stats cannot be used with -c\n");
+            free(req);
+            return e_failure;
+        }
+        req->op = SERVER_OP_ENCODE;
+        absolute_path(req->src_fname, encInfo.src_image_fname);
+        absolute_path(req->secret_fname, encInfo.secret_fname);
+        absolute_path(req->out_fname, encInfo.stego_image_fname);
+        strcpy(req->extn_secret_file, encInfo.extn_secret_file);
+        req->adaptive_threshold = encInfo.adaptive ? encInfo.threshold : -1;
+        req->fec_nsym = encInfo.fec_nsym;
+        req->output_flags = encInfo.output_flags & (OUTPUT_DROP_CACHE | OUTPUT_DIRECT);
+        fds[nfds++] = open(encInfo.src_image_fname, O_RDONLY | O_CLOEXEC);
+        fds[nfds++] = open(encInfo.secret_fname, O_RDONLY | O_CLOEXEC);
+        fds[nfds++] = open(encInfo.stego_image_fname, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    }
+    else if (check_operation_type(argv, argc) == e_decode)
+    {
+        if (read_and_validate_decode_args(argc, argv, &encInfod) != d_success)
+        {
+            printf("Usage: ./a.out -c <socket> -d <encodedfile.bmp|.png> [output.txt]\n");
+            free(req);
+            return e_failure;
+        }
+        req->op = SERVER_OP_DECODE;
+        absolute_path(req->src_fname, encInfod.stego_image_fname);
+        // Output is created by the server once the extension is known
+        if (!is_client_path(encInfod.stego_image_fname) || !is_client_path(encInfod.buf) ||
+            absolute_path(req->out_fname, encInfod.buf) != e_success)
+        {
+            fclose(encInfod.fptr_stego_image);
+            free(req);
+            return e_failure;
+        }
+        fds[nfds++] = dup(fileno(encInfod.fptr_stego_image));
+        fclose(encInfod.fptr_stego_image);
+    }
+    else
+    {
+        printf("Usage: ./a.out -c <socket> -e|-d|-p <args...>\n");
+        free(req);
+        return e_failure;
+    }
+
+    for (int i = 0; i < nfds; i++)
+    {
+        if (fds[i] < 0)
+        {
+            perror("open");
+            goto out;
+        }
+    }
+
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (strlen(socket_path) >= sizeof(addr.sun_path))
+        goto out;
+    strcpy(addr.sun_path, socket_path);
+
+    int sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (sock < 0 || connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        perror("connect");
+        if (sock >= 0)
+            close(sock);
+        goto out;
+    }
+
+    union
+    {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(3 * sizeof(int))];
+    } control;
+    struct iovec iov = { req, sizeof(*req) };
+    struct msghdr msg = { 0 };
+
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = CMSG_SPACE(nfds * sizeof(int));
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(nfds * sizeof(int));
+    memcpy(CMSG_DATA(cmsg), fds, nfds * sizeof(int));
+
+    ServerReply reply;
+    if (sendmsg(sock, &msg, MSG_NOSIGNAL) != sizeof(*req) || recv(sock, &reply, sizeof(reply), 0) != sizeof(reply))
+    {
+        fprintf(stderr, "❌ ERROR: No reply from server %s\n", socket_path);
+        close(sock);
+        goto out;
+    }
+    close(sock);
+
+    reply.message[SERVER_MSG_SIZE - 1] = '\0';
+    printf("%s %s\n", reply.status == e_success ? "✅" : "❌", reply.message);
+    ret = reply.status == e_success ? e_success : e_failure;
+
+out:
+    for (int i = 0; i < nfds; i++)
+        if (fds[i] >= 0)
+            close(fds[i]);
+    // The output was created here, a failed encode must not leave it behind
+    if (ret != e_success && req->op == SERVER_OP_ENCODE && fds[2] >= 0)
+        remove(encInfo.stego_image_fname);
+    free(req);
+    return ret;
+}
@@ -0,0 +1,62 @@
+/* Name : Shobharaj H L
+   Date : 12/11/2025
+   Description : LSB_IMAGE_STEGANOGRAPHY */
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "typese.h" // Contains user defined types
+
+/*
+ * Long running server mode: jobs are sent over a Unix domain
+ * socket and executed by a fixed pool of worker threads, so a
+ * request does not pay for exec, linking and cold caches.
+ */
+
+#define SERVER_PATH_MAX 4096
+#define SERVER_MSG_SIZE 256
+#define SERVER_WORKERS 4
+#define SERVER_QUEUE_SIZE 64
+#define SERVER_IO_BUF_SIZE (64 * 1024)
+#define SERVER_IDLE_TIMEOUT 5 // seconds a connection may hold a worker waiting for its next request
+
+/* Request operations */
+#define SERVER_OP_ENCODE 'e'
+#define SERVER_OP_DECODE 'd'
+#define SERVER_OP_PROBE 'p'
+
+/*
+ * One request per SOCK_SEQPACKET message. Files are either
+ * passed as open descriptors (SCM_RIGHTS) in the order
+ * src, secret, stego for encode and stego for decode/probe,
+ * or named by the absolute paths below when no fds are sent.
+ * Either way the server opens files with its own privileges,
+ * so the socket is only accessible to the user running it.
+ */
+typedef struct ServerRequest
+{
+    char op;//one of SERVER_OP_*
+    char src_fname[SERVER_PATH_MAX];//cover image (encode) or stego image (decode/probe)
+    char secret_fname[SERVER_PATH_MAX];//secret file (encode)
+    char out_fname[SERVER_PATH_MAX];//stego image (encode) or output name without extension (decode)
+    char extn_secret_file[8];//extension of the secret file (encode)
+    short adaptive_threshold;//-1 for sequential embedding (encode)
+    short fec_nsym;//Reed-Solomon parity bytes per block, 0 for none (encode)
+    short output_flags;//OUTPUT_DROP_CACHE / OUTPUT_DIRECT for the stego image (encode)
+} ServerRequest;
+
+typedef struct ServerReply
+{
+    int status;//e_success or e_failure
+    char message[SERVER_MSG_SIZE];//human readable result
+} ServerReply;
+
+
+/* Server function prototype */
+
+/* Listen on socket_path and serve requests until killed */
+Status run_server(const char *socket_path, int workers);
+
+/* Send the CLI arguments (argv[1] onwards: -e/-d/-p ...) to a running server */
+Status run_client(const char *socket_path, int argc, char *argv[]);
+
+#endif
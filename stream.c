@@ -0,0 +1,63 @@
+/* Name : Shobharaj H L
+   Date : 12/11/2025
+   Description : LSB_IMAGE_STEGANOGRAPHY */
+#define _FILE_OFFSET_BITS 64
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "stream.h"
+
+ // Function: is_stream_name
+ // Purpose : "-" means stdin for inputs and stdout for outputs
+int is_stream_name(const char *fname)
+{
+    return fname != NULL && strcmp(fname, STREAM_NAME) == 0;
+}
+
+ // Function: open_input_stream
+ // Purpose : Open a path, or wrap an inherited descriptor given as "fd:<n>"
+FILE *open_input_stream(const char *fname)
+{
+    FILE *fptr;
+
+    if (is_stream_name(fname))
+        return stdin;
+
+    if (strncmp(fname, STREAM_FD_PREFIX, strlen(STREAM_FD_PREFIX)) == 0)
+    {
+        char *end;
+        long fd = strtol(fname + strlen(STREAM_FD_PREFIX), &end, 10);
+        if (*end != '\0' || fd < 0)
+            return NULL;
+        fptr = fdopen((int)fd, "rb");
+    }
+    else
+        fptr = fopen(fname, "rb");
+
+    // Inputs are read once front to back: ask for a large readahead (ignored on pipes)
+    if (fptr != NULL)
+        posix_fadvise(fileno(fptr), 0, 0, POSIX_FADV_SEQUENTIAL);
+    return fptr;
+}
+
+ // Function: stdout_data_stream
+ // Purpose : Keep the real stdout for data and send every printf to stderr
+FILE *stdout_data_stream(void)
+{
+    static FILE *data_stream;
+
+    if (data_stream == NULL)
+    {
+        fflush(stdout);
+        int fd = dup(STDOUT_FILENO);
+        if (fd < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0)
+        {
+            perror("dup");
+            return NULL;
+        }
+        data_stream = fdopen(fd, "wb");
+    }
+    return data_stream;
+}
@@ -0,0 +1,26 @@
+/* Name : Shobharaj H L
+   Date : 12/11/2025
+   Description : LSB_IMAGE_STEGANOGRAPHY */
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stdio.h>
+
+/*
+ * Helpers for the pipe friendly mode, where "-" names stdin/stdout
+ * and "fd:<n>" names an already open file descriptor.
+ */
+
+#define STREAM_NAME "-"
+#define STREAM_FD_PREFIX "fd:"
+
+/* Check whether a file name means stdin/stdout */
+int is_stream_name(const char *fname);
+
+/* Open "fd:<n>" or a regular path for reading */
+FILE *open_input_stream(const char *fname);
+
+/* Stream for data written to stdout, messages are moved to stderr */
+FILE *stdout_data_stream(void);
+
+#endif
@@ -1,11 +1,21 @@
 /* Name : Shobharaj H L
    Date : 12/11/2025
    Description : LSB_IMAGE_STEGANOGRAPHY */
+#define _FILE_OFFSET_BITS 64 // 64-bit off_t, fseeko and ftello for covers over 4 GB
 #include <stdio.h>
 #include <string.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include "encode.h"
 #include "decode.h"
+#include "server.h"
+#include "analyze.h"
+#include "adaptive.h"
+#include "rs.h"
+#include "cover.h"
+#include "stream.h"
+#include "png.h"
+#include "output.h"
 #include "typese.h"
 #include "typesd.h"
 #include "common.h"
@@ -23,43 +33,163 @@ OperationType check_operation_type(char* argv[], int argc)
         return e_encode;
     else if (strcmp(argv[1], "-d") == 0)
         return e_decode;
+    else if (strcmp(argv[1], "-s") == 0)
+        return e_server;
+    else if (strcmp(argv[1], "-c") == 0)
+        return e_client;
+    else if (strcmp(argv[1], "--analyze") == 0)
+        return e_analyze;
+    else if (strcmp(argv[1], "-m") == 0)
+        return e_batch;
     else
         return e_unsupported;
 }
 
 
+ // Function: is_image_name
+ // Purpose: Covers and stego images are .bmp or .png files
+static int is_image_name(const char *fname)
+{
+    return strstr(fname, ".bmp") != NULL || is_png_name(fname);
+}
+
+ // Function: read_option_number
+ // Purpose : Parse the decimal value of an option, rejecting empty, signed or trailing text
+static Status read_option_number(const char *str, long min, long max, int *value)
+{
+    char *end;
+    long num;
+
+    if (*str < '0' || *str > '9')
+        return e_failure;
+    num = strtol(str, &end, 10);
+    if (*end != '\0' || num < min || num > max)
+        return e_failure;
+    *value = num;
+    return e_success;
+}
+
+ // Function: read_encode_option
+ // Purpose: Parse one "--" option shared by single and batch encoding
+static Status read_encode_option(const char *arg, EncodeInfo *encInfo)
+{
+    if (strncmp(arg, "--adaptive", 10) == 0)
+    {
+        // --adaptive[=threshold]
+        encInfo->adaptive = 1;
+        if (arg[10] == '=')
+        {
+            int threshold;
+            if (read_option_number(arg + 11, 0, 254, &threshold) != e_success)
+                return e_failure;
+            encInfo->threshold = threshold;
+        }
+        else if (arg[10] != '\0')
+            return e_failure;
+    }
+    else if (strncmp(arg, "--fec", 5) == 0)
+    {
+        // --fec[=parity bytes per 255 byte block]
+        encInfo->fec_nsym = RS_DEFAULT_NSYM;
+        if (arg[5] == '=')
+        {
+            if (read_option_number(arg + 6, 2, RS_MAX_NSYM, &encInfo->fec_nsym) != e_success)
+                return e_failure;
+        }
+        else if (arg[5] != '\0')
+            return e_failure;
+    }
+    else if (strcmp(arg, "--drop-cache") == 0)
+        encInfo->output_flags |= OUTPUT_DROP_CACHE;
+    else if (strcmp(arg, "--direct") == 0)
+        encInfo->output_flags |= OUTPUT_DIRECT;
+    else if (strcmp(arg, "--stats") == 0)
+        encInfo->output_flags |= OUTPUT_STATS;
+    else
+        return e_failure;
+
+    // Protected data is embedded sequentially only
+    if (encInfo->adaptive && encInfo->fec_nsym)
+        return e_failure;
+
+    return e_success;
+}
+
  // Function: read_and_validate_encode_args
  // Purpose: Validate all arguments for encoding mode
 Status read_and_validate_encode_args(int argc, char *argv[], EncodeInfo *encInfo)
 {
-    // Need at least: ./a.out -e <source.bmp> <secret.txt>
+    // Need at least: ./a.out -e <source.bmp|.png> <secret.txt>
     if (argc < 4)
         return e_failure;
 
-    // Check .bmp source image
-    if (strstr(argv[2], ".bmp") == NULL)
+    // Check .bmp/.png source image, "-" reads a BMP from stdin
+    if (!is_image_name(argv[2]) && !is_stream_name(argv[2]))
         return e_failure;
     encInfo->src_image_fname = argv[2];
 
-    // Check .txt secret file
-    if (strstr(argv[3], ".txt") == NULL)
+    // Check .txt secret file, "fd:<n>" reads it from an open descriptor
+    if (strstr(argv[3], ".txt") == NULL && strncmp(argv[3], STREAM_FD_PREFIX, strlen(STREAM_FD_PREFIX)) != 0)
         return e_failure;
     encInfo->secret_fname = argv[3];
     strcpy(encInfo->extn_secret_file, ".txt");
 
-    // Optional output image
-    if (argc == 5)
+    // Optional output image, then options
+    encInfo->stego_image_fname = is_png_name(argv[2]) ? "stego.png" : "stego.bmp";  // default name
+    encInfo->adaptive = 0;
+    encInfo->threshold = ADAPTIVE_DEFAULT_THRESHOLD;
+    encInfo->fec_nsym = 0;
+    encInfo->output_flags = 0;
+
+    for (int i = 4; i < argc; i++)
     {
-        if (strstr(argv[4], ".bmp") == NULL)
+        if (strncmp(argv[i], "--", 2) == 0)
+        {
+            if (read_encode_option(argv[i], encInfo) != e_success)
+                return e_failure;
+        }
+        else if (i == 4 && (is_image_name(argv[4]) || is_stream_name(argv[4])))
+            encInfo->stego_image_fname = argv[4];
+        else
             return e_failure;
-        encInfo->stego_image_fname = argv[4];
     }
-    else
+
+    // The stego image keeps the format of its cover
+    if (is_png_name(encInfo->src_image_fname) != is_png_name(encInfo->stego_image_fname))
+        return e_failure;
+
+    return e_success;
+}
+
+ // Function: read_and_validate_batch_args
+ // Purpose: Validate ./a.out -m <cover.bmp|.png> <secret.txt> <output.bmp|.png>... [options]
+Status read_and_validate_batch_args(int argc, char *argv[], EncodeInfo *options, int *npairs)
+{
+    if (argc < 5 || !is_image_name(argv[2]))
+        return e_failure;
+
+    memset(options, 0, sizeof(*options));
+    strcpy(options->extn_secret_file, ".txt");
+    options->threshold = ADAPTIVE_DEFAULT_THRESHOLD;
+    options->output_flags = OUTPUT_DROP_CACHE;  // bulk runs keep their outputs out of the page cache
+
+    // <secret> <output> pairs first, options after them
+    int i = 3;
+    for (; i + 1 < argc && strncmp(argv[i], "--", 2) != 0; i += 2)
     {
-        encInfo->stego_image_fname = "stego.bmp";  // default name
+        if ((strstr(argv[i], ".txt") == NULL && strncmp(argv[i], STREAM_FD_PREFIX, strlen(STREAM_FD_PREFIX)) != 0) ||
+            !is_image_name(argv[i + 1]) || is_png_name(argv[i + 1]) != is_png_name(argv[2]))
+            return e_failure;
     }
+    *npairs = (i - 3) / 2;
 
-    return e_success;
+    for (; i < argc; i++)
+    {
+        if (read_encode_option(argv[i], options) != e_success)
+            return e_failure;
+    }
+
+    return *npairs > 0 ? e_success : e_failure;
 }
 
  //Function: read_and_validate_decode_args
@@ -70,13 +200,13 @@ Statusd read_and_validate_decode_args(int argc, char *argv[], EncodeInfod *encIn
     if (argc < 3)
         return d_failure;
 
-    // Validate stego image
-    if (strstr(argv[2], ".bmp") == NULL)
+    // Validate stego image, "-" reads it from stdin
+    if (!is_image_name(argv[2]) && !is_stream_name(argv[2]))
         return d_failure;
     encInfod->stego_image_fname = argv[2];
 
     // Try opening file
-    encInfod->fptr_stego_image = fopen(encInfod->stego_image_fname, "rb");
+    encInfod->fptr_stego_image = open_input_stream(encInfod->stego_image_fname);
     if (encInfod->fptr_stego_image == NULL)
     {
         perror("fopen");
@@ -101,6 +231,14 @@ Statusd read_and_validate_decode_args(int argc, char *argv[], EncodeInfod *encIn
 
 int main(int argc, char *argv[])
 {
+    // Data goes to stdout: move all messages to stderr before printing any
+    if ((check_operation_type(argv, argc) == e_encode && argc >= 5 && is_stream_name(argv[4])) ||
+        (check_operation_type(argv, argc) == e_decode && argc == 4 && is_stream_name(argv[3])))
+    {
+        if (stdout_data_stream() == NULL)
+            return 1;
+    }
+
     printf("--------------------------------------------------------------------\n");
     printf("\n\t\t✨🖼️  LSB IMAGE STEGANOGRAPHY 🔐✨\n");
     printf("\n--------------------------------------------------------------------\n");
@@ -109,8 +247,12 @@ int main(int argc, char *argv[])
     {
         printf("❌ Invalid input.\n");
         printf("Usage:\n");
-        printf("./a.out -e <source.bmp> <secret.txt> [output.bmp]\n");
-        printf("./a.out -d <encoded.bmp> [output.txt]\n");
+        printf("./a.out -e <source.bmp|.png> <secret.txt> [output.bmp|.png] [--adaptive[=threshold] | --fec[=nsym]] [--drop-cache] [--direct] [--stats]\n");
+        printf("./a.out -d <encoded.bmp|.png> [output.txt]\n");
+        printf("./a.out -s <socket> [workers]\n");
+        printf("./a.out -c <socket> -e|-d|-p <args...>\n");
+        printf("./a.out -m <cover.bmp|.png> <secret.txt> <output.bmp|.png> [<secret.txt> <output.bmp|.png>...] [options]\n");
+        printf("./a.out --analyze <image.bmp|.png|directory> [threads]\n");
         return 1;
     }
 
@@ -123,7 +265,7 @@ int main(int argc, char *argv[])
         if (read_and_validate_encode_args(argc, argv, &encInfo) != e_success)
         {
             printf("❌ Invalid input for encoding.\n");
-            printf("Usage: ./a.out -e <source.bmp> <secret.txt> [output.bmp]\n");
+            printf("Usage: ./a.out -e <source.bmp|.png> <secret.txt> [output.bmp|.png] [--adaptive[=threshold] | --fec[=nsym]] [--drop-cache] [--direct] [--stats]\n");
             return e_failure;
         }
 
@@ -137,7 +279,15 @@ int main(int argc, char *argv[])
         if (read_and_validate_decode_args(argc, argv, &encInfod) != d_success)
         {
             printf("❌ Invalid input for decoding.\n");
-            printf("Usage: ./a.out -d <encodedfile.bmp> [output.txt]\n");
+            printf("Usage: ./a.out -d <encodedfile.bmp|.png> [output.txt]\n");
+            return d_failure;
+        }
+
+        // PNG stego images are decoded into their BMP view first
+        if (is_png_name(encInfod.stego_image_fname) &&
+            (encInfod.fptr_stego_image = png_input_stream(encInfod.fptr_stego_image)) == NULL)
+        {
+            printf("❌ Decoding failed.\n");
             return d_failure;
         }
 
@@ -146,12 +296,66 @@ int main(int argc, char *argv[])
         else
             printf("❌ Decoding failed.\n");
     }
+    else if (check_operation_type(argv, argc) == e_server)
+    {
+        if (argc < 3)
+        {
+            printf("Usage: ./a.out -s <socket> [workers]\n");
+            return e_failure;
+        }
+
+        if (run_server(argv[2], argc == 4 ? atoi(argv[3]) : SERVER_WORKERS) != e_success)
+        {
+            printf("❌ Server stopped.\n");
+            return e_failure;
+        }
+    }
+    else if (check_operation_type(argv, argc) == e_client)
+    {
+        if (argc < 4)
+        {
+            printf("Usage: ./a.out -c <socket> -e|-d|-p <args...>\n");
+            return e_failure;
+        }
+
+        // Client takes the same arguments as the CLI after the socket
+        if (run_client(argv[2], argc - 2, argv + 2) != e_success)
+            return e_failure;
+    }
+    else if (check_operation_type(argv, argc) == e_batch)
+    {
+        int npairs;
+        if (read_and_validate_batch_args(argc, argv, &encInfo, &npairs) != e_success)
+        {
+            printf("❌ Invalid input for batch encoding.\n");
+            printf("Usage: ./a.out -m <cover.bmp|.png> <secret.txt> <output.bmp|.png> [<secret.txt> <output.bmp|.png>...] [options]\n");
+            return e_failure;
+        }
+
+        if (do_batch_encoding(argv[2], npairs, argv + 3, &encInfo) != e_success)
+            printf("❌ Some secrets could not be embedded.\n");
+    }
+    else if (check_operation_type(argv, argc) == e_analyze)
+    {
+        if (argc < 3)
+        {
+            printf("Usage: ./a.out --analyze <image.bmp|.png|directory> [threads]\n");
+            return e_failure;
+        }
+
+        if (run_analyze(argv[2], argc == 4 ? atoi(argv[3]) : 0) != e_success)
+            return e_failure;
+    }
     else
     {
         printf("❌ Invalid operation type !!!\n");
         printf("Usage:\n");
-        printf("./a.out -e <source.bmp> <secret.txt> [output.bmp]\n");
-        printf("./a.out -d <encodedfile.bmp> [output.txt]\n");
+        printf("./a.out -e <source.bmp|.png> <secret.txt> [output.bmp|.png] [--adaptive[=threshold] | --fec[=nsym]] [--drop-cache] [--direct] [--stats]\n");
+        printf("./a.out -d <encodedfile.bmp|.png> [output.txt]\n");
+        printf("./a.out -s <socket> [workers]\n");
+        printf("./a.out -c <socket> -e|-d|-p <args...>\n");
+        printf("./a.out -m <cover.bmp|.png> <secret.txt> <output.bmp|.png> [<secret.txt> <output.bmp|.png>...] [options]\n");
+        printf("./a.out --analyze <image.bmp|.png|directory> [threads]\n");
         return 1;
     }
 
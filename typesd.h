@@ -1,6 +1,9 @@
 #ifndef TYPESD_H
 #define TYPESD_H
 
+#include <stdint.h>
+#include <sys/types.h>
+
 /* User defined types */
 typedef unsigned int uint;
 
@@ -1,6 +1,9 @@
 #ifndef TYPESE_H
 #define TYPESE_H
 
+#include <stdint.h>
+#include <sys/types.h>
+
 /* User defined types */
 typedef unsigned int uint;
 
@@ -15,7 +18,11 @@ typedef enum
 {
     e_encode,//0
     e_decode,//1
-    e_unsupported//2
+    e_server,//2
+    e_client,//3
+    e_analyze,//4
+    e_batch,//5
+    e_unsupported//6
 } OperationType;
 
 #endif